@@ -33,25 +33,26 @@ constexpr int TICK_SIZE_IN_CENTS = 100;
 constexpr int MIN_BID_NEARST_TICK = (MINIMUM_BID + TICK_SIZE_IN_CENTS) / TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
 constexpr int MAX_ASK_NEAREST_TICK = MAXIMUM_ASK / TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
 
-#include <chrono>
-#include <cstdint>
-#include <iostream>
-
-uint64_t epoch_time() {
-  using namespace std::chrono;
-  return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
-}
-
-AutoTrader::AutoTrader(boost::asio::io_context& context) : BaseAutoTrader(context)
+AutoTrader::AutoTrader(boost::asio::io_context& context,
+                       const std::string& recording,
+                       RecorderPool* pool) : BaseAutoTrader(context),
+                                             mRecorder(recording, mClock, pool)
 {
-	mOutFileETF.open("market_data_etf.csv");
-	mOutFileFuture.open("market_data_future.csv");
 }
 
 void AutoTrader::DisconnectHandler()
 {
-	mOutFileETF.close();
-	mOutFileFuture.close();
+	mRecorder.Close();
+	if (mRecorder.DroppedCount() != 0)
+	{
+		RLOG(LG_AT, LogLevel::LL_INFO) << "recorder dropped " << mRecorder.DroppedCount()
+		                               << " order book updates";
+	}
+	if (mRecorder.UnwrittenCount() != 0)
+	{
+		RLOG(LG_AT, LogLevel::LL_ERROR) << "recorder failed to write " << mRecorder.UnwrittenCount()
+		                                << " order book updates";
+	}
 }
 
 void AutoTrader::ErrorMessageHandler(unsigned long clientOrderId,
@@ -75,16 +76,8 @@ void AutoTrader::OrderBookMessageHandler(Instrument instrument,
                                          const std::array<unsigned long, TOP_LEVEL_COUNT>& bidVolumes)
 {
 	
-	auto& fileOut = instrument == Instrument::FUTURE ? mOutFileFuture : mOutFileETF;
-
-	fileOut << epoch_time();
-	for(int i = 0; i < TOP_LEVEL_COUNT; i++) {
-		fileOut << "," << askPrices[i] << "," << askVolumes[i];
-	}
-	for(int i = 0; i < TOP_LEVEL_COUNT; i++) {
-		fileOut << "," << bidPrices[i] << "," << bidVolumes[i];
-	}
-	fileOut << std::endl;
+	mRecorder.Record(RecordKind::ORDER_BOOK, instrument, sequenceNumber, mClock.Now(),
+	                 askPrices, askVolumes, bidPrices, bidVolumes);
 
 }
 
@@ -110,5 +103,6 @@ void AutoTrader::TradeTicksMessageHandler(Instrument instrument,
                                           const std::array<unsigned long, TOP_LEVEL_COUNT>& bidPrices,
                                           const std::array<unsigned long, TOP_LEVEL_COUNT>& bidVolumes)
 {
-
+	mRecorder.Record(RecordKind::TRADE_TICKS, instrument, sequenceNumber, mClock.Now(),
+	                 askPrices, askVolumes, bidPrices, bidVolumes);
 }
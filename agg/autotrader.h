@@ -22,14 +22,15 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
-#include <iostream>
-#include <fstream>
 
 #include <boost/asio/io_context.hpp>
 
 #include <ready_trader_go/baseautotrader.h>
 #include <ready_trader_go/types.h>
 
+#include "monotonicclock.h"
+#include "recorder.h"
+
 struct Order {
 	
 	unsigned long price;
@@ -42,7 +43,11 @@ struct Order {
 class AutoTrader : public ReadyTraderGo::BaseAutoTrader
 {
 public:
-    explicit AutoTrader(boost::asio::io_context& context);
+    // Records the market to the given file, using the pool's writer thread
+    // if there is one.
+    explicit AutoTrader(boost::asio::io_context& context,
+                        const std::string& recording = "market_data.bin",
+                        RecorderPool* pool = nullptr);
 
     // Called when the execution connection is lost.
     void DisconnectHandler() override;
@@ -105,8 +110,8 @@ public:
                                   const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>& bidVolumes) override;
 
 private:
-	std::ofstream mOutFileETF;
-	std::ofstream mOutFileFuture;
+	MonotonicClock mClock;
+	BookRecorder mRecorder;
 };
 
 #endif //CPPREADY_TRADER_GO_AUTOTRADER_H
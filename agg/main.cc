@@ -15,17 +15,72 @@
 //     You should have received a copy of the GNU Affero General Public
 //     License along with Ready Trader Go.  If not, see
 //     <https://www.gnu.org/licenses/>.
+// With no arguments, records one session configured by the JSON file named
+// after the executable, as any autotrader is. Otherwise each argument names
+// a session to record in this process: the session is configured by
+// NAME.json, runs on a thread of its own and records to NAME.bin. All of
+// the sessions share one writer thread.
+//
+// Each session needs an Application of its own: the library opens the
+// information channel and the execution connection only from an
+// Application's configuration, one set per Application, and has no
+// lighter-weight feed handler to give a session. The Applications share
+// nothing but the process. Boost.Log's core is thread-safe, so each may add
+// its sinks while the others log, and Boost.Asio lets any number of
+// signal_sets wait for the same signal, each being told of it, so Ctrl-C
+// stops every session. Every other piece of state, the io_context included,
+// belongs to one Application and is only touched from its own thread.
+//
+// Usage: autotrader [SESSION...]
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <ready_trader_go/application.h>
 #include <ready_trader_go/autotraderapphandler.h>
 #include <ready_trader_go/error.h>
 
 #include "autotrader.h"
+#include "recorder.h"
+
+static void RunSession(std::string name, RecorderPool& pool)
+{
+    try
+    {
+        ReadyTraderGo::Application app;
+        AutoTrader trader{app.GetContext(), name + ".bin", &pool};
+        ReadyTraderGo::AutoTraderAppHandler appHandler{app, trader};
+        // The application finds its configuration by its program name
+        char* args[] = {&name[0], nullptr};
+        app.Run(1, args);
+    }
+    catch (const ReadyTraderGo::ReadyTraderGoError& e)
+    {
+        std::cerr << name << ": " << e.what() << std::endl;
+    }
+}
 
 int main(int argc, char* argv[])
 {
+    if (argc > 1)
+    {
+        RecorderPool pool;
+        std::vector<std::thread> sessions;
+        for (int i = 1; i < argc; i++)
+        {
+            sessions.emplace_back(RunSession, std::string(argv[i]),
+                                  std::ref(pool));
+        }
+        for (std::thread& session : sessions)
+        {
+            session.join();
+        }
+        return EXIT_SUCCESS;
+    }
+
     try
     {
         ReadyTraderGo::Application app;
@@ -0,0 +1,131 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+
+// Converts a binary recording made by the autotrader into the two CSV files
+// the recorder used to write directly. Each row starts with the wall-clock
+// capture time in nanoseconds and the exchange sequence number.
+//
+// Only order book records are converted; trade ticks are counted and
+// skipped. Sequence gaps and out-of-order updates are counted per instrument
+// and reported once the conversion is done.
+//
+// Usage: record2csv [RECORDING [ETF_CSV FUTURE_CSV]]
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+#include "bookrecord.h"
+#include "sequencetracker.h"
+
+using namespace ReadyTraderGo;
+
+static void WriteRow(std::ostream &out, const BookFileHeader &header,
+                     const BookRecord &record) {
+    out << header.wallClockAtStart +
+               (record.timestamp - header.monotonicAtStart)
+        << "," << record.sequenceNumber;
+    for (int i = 0; i < TOP_LEVEL_COUNT; i++) {
+        out << "," << record.askPrices[i] << "," << record.askVolumes[i];
+    }
+    for (int i = 0; i < TOP_LEVEL_COUNT; i++) {
+        out << "," << record.bidPrices[i] << "," << record.bidVolumes[i];
+    }
+    out << '\n';
+}
+
+int main(int argc, char *argv[]) {
+    const char *inputName = argc > 1 ? argv[1] : "market_data.bin";
+    const char *etfName = argc > 3 ? argv[2] : "market_data_etf.csv";
+    const char *futureName = argc > 3 ? argv[3] : "market_data_future.csv";
+
+    std::ifstream in(inputName, std::ios::binary);
+    if (!in) {
+        std::cerr << "unable to open " << inputName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BookFileHeader header{};
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, BOOK_RECORD_MAGIC,
+                           sizeof(header.magic)) != 0) {
+        std::cerr << inputName << " is not a book recording" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (header.version != BOOK_RECORD_VERSION ||
+        header.recordSize != sizeof(BookRecord)) {
+        std::cerr << inputName << " has unsupported version "
+                  << header.version << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream etfOut(etfName);
+    std::ofstream futureOut(futureName);
+    if (!etfOut || !futureOut) {
+        std::cerr << "unable to create " << (etfOut ? futureName : etfName)
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    SequenceTracker etfStats;
+    SequenceTracker futureStats;
+
+    std::vector<BookRecord> chunk(4096);
+    unsigned long count = 0;
+    unsigned long tradeTicks = 0;
+    while (in) {
+        in.read(reinterpret_cast<char *>(chunk.data()),
+                chunk.size() * sizeof(BookRecord));
+        auto records = static_cast<std::size_t>(in.gcount()) /
+                       sizeof(BookRecord);
+        for (std::size_t i = 0; i < records; i++) {
+            const BookRecord &record = chunk[i];
+            if (record.kind != RecordKind::ORDER_BOOK) {
+                tradeTicks++;
+                continue;
+            }
+            bool isFuture = record.instrument ==
+                            static_cast<std::uint8_t>(Instrument::FUTURE);
+            (isFuture ? futureStats : etfStats).Update(record.sequenceNumber);
+            WriteRow(isFuture ? futureOut : etfOut, header, record);
+        }
+        count += records;
+    }
+
+    // The streams' state is sticky, so this catches any failed write
+    etfOut.close();
+    futureOut.close();
+    if (!etfOut || !futureOut) {
+        std::cerr << "unable to write " << (etfOut ? futureName : etfName)
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "converted " << count - tradeTicks << " order books, skipped "
+              << tradeTicks << " trade ticks" << std::endl;
+    std::cout << "etf: " << etfStats.Count() << " updates, "
+              << etfStats.Missing() << " missing, " << etfStats.Reordered()
+              << " out of order" << std::endl;
+    std::cout << "future: " << futureStats.Count() << " updates, "
+              << futureStats.Missing() << " missing, "
+              << futureStats.Reordered() << " out of order" << std::endl;
+    return EXIT_SUCCESS;
+}
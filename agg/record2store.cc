@@ -0,0 +1,105 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+// Converts a binary recording made by the autotrader into a columnar book
+// store (see bookstore.h), which the replay tools can read a time window at
+// a time. With -z, prices, volumes, timestamps and sequence numbers are
+// delta and varint encoded; otherwise every column can be used straight
+// from the mapped file.
+//
+// Usage: record2store [-z] [-b BLOCK_RECORDS] [RECORDING [STORE]]
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <ready_trader_go/error.h>
+
+#include "bookrecord.h"
+#include "bookstore.h"
+
+int main(int argc, char *argv[]) {
+    bool compress = false;
+    unsigned long blockRecords = BookStoreWriter::DEFAULT_BLOCK_RECORDS;
+    std::vector<const char *> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-z") == 0) {
+            compress = true;
+        } else if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            const char *value = argv[++i];
+            char *end = nullptr;
+            blockRecords = std::strtoul(value, &end, 10);
+            if (end == value || *end != '\0' || blockRecords == 0 ||
+                blockRecords > BookStoreWriter::MAX_BLOCK_RECORDS) {
+                std::cerr << "-b must be between 1 and "
+                          << BookStoreWriter::MAX_BLOCK_RECORDS << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    const char *inputName = args.size() > 0 ? args[0] : "market_data.bin";
+    const char *storeName = args.size() > 1 ? args[1] : "market_data.store";
+
+    std::ifstream in(inputName, std::ios::binary);
+    if (!in) {
+        std::cerr << "unable to open " << inputName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BookFileHeader header{};
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, BOOK_RECORD_MAGIC,
+                           sizeof(header.magic)) != 0) {
+        std::cerr << inputName << " is not a book recording" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (header.version != BOOK_RECORD_VERSION ||
+        header.recordSize != sizeof(BookRecord)) {
+        std::cerr << inputName << " has unsupported version "
+                  << header.version << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    unsigned long count = 0;
+    try {
+        BookStoreWriter store(storeName, header, compress,
+                              static_cast<std::uint32_t>(blockRecords));
+        std::vector<BookRecord> chunk(4096);
+        while (in) {
+            in.read(reinterpret_cast<char *>(chunk.data()),
+                    chunk.size() * sizeof(BookRecord));
+            auto records = static_cast<std::size_t>(in.gcount()) /
+                           sizeof(BookRecord);
+            for (std::size_t i = 0; i < records; i++) {
+                store.Append(chunk[i]);
+            }
+            count += records;
+        }
+        store.Close();
+    } catch (const ReadyTraderGo::ReadyTraderGoError &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream stored(storeName, std::ios::binary | std::ios::ate);
+    std::cout << "stored " << count << " records in " << stored.tellg()
+              << " bytes" << (compress ? " (compressed)" : "") << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_BOOKKERNELS_H
+#define CPPREADY_TRADER_GO_BOOKKERNELS_H
+
+#include <array>
+
+#include <ready_trader_go/types.h>
+
+// Kernels over the price and volume arrays delivered with every order book
+// and trade ticks message.
+//
+// The implementation is chosen at compile time from the target flags (see
+// RTG_SIMD in common/simd.cmake): AVX2, SSE4.1 or plain scalar code, which
+// RTG_BOOK_KERNELS_SCALAR forces whatever the target. The vector versions
+// multiply with 32x32->64 bit instructions, so prices and volumes must fit
+// in 32 bits, as they do on the exchange's wire protocol.
+#if defined(RTG_BOOK_KERNELS_SCALAR)
+// Nothing to include
+#elif defined(__LP64__) && defined(__AVX2__)
+#define RTG_BOOK_KERNELS_AVX2 1
+#include <immintrin.h>
+#elif defined(__LP64__) && defined(__SSE4_1__)
+#define RTG_BOOK_KERNELS_SSE4 1
+#include <smmintrin.h>
+#endif
+
+namespace BookKernels {
+
+using Levels = std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>;
+
+// The implementation compiled in
+#if defined(RTG_BOOK_KERNELS_AVX2)
+constexpr const char *IMPLEMENTATION = "AVX2";
+#elif defined(RTG_BOOK_KERNELS_SSE4)
+constexpr const char *IMPLEMENTATION = "SSE4";
+#else
+constexpr const char *IMPLEMENTATION = "SCALAR";
+#endif
+
+#if defined(RTG_BOOK_KERNELS_AVX2) || defined(RTG_BOOK_KERNELS_SSE4)
+static_assert(ReadyTraderGo::TOP_LEVEL_COUNT == 5,
+              "the vector kernels assume five levels");
+#endif
+
+#if defined(RTG_BOOK_KERNELS_AVX2)
+
+inline __m256i Load4(const unsigned long *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+inline unsigned long HorizontalSum(__m256i v) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+    return static_cast<unsigned long>(_mm_cvtsi128_si64(s) +
+                                      _mm_extract_epi64(s, 1));
+}
+
+#elif defined(RTG_BOOK_KERNELS_SSE4)
+
+inline __m128i Load2(const unsigned long *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+inline unsigned long HorizontalSum(__m128i v) {
+    return static_cast<unsigned long>(_mm_cvtsi128_si64(v) +
+                                      _mm_extract_epi64(v, 1));
+}
+
+#endif
+
+// Total volume across all levels.
+inline unsigned long TotalVolume(const Levels &volumes) {
+#if defined(RTG_BOOK_KERNELS_AVX2)
+    return HorizontalSum(Load4(volumes.data())) + volumes[4];
+#elif defined(RTG_BOOK_KERNELS_SSE4)
+    return HorizontalSum(_mm_add_epi64(Load2(volumes.data()),
+                                       Load2(volumes.data() + 2))) +
+           volumes[4];
+#else
+    unsigned long total = 0;
+    for (unsigned long volume : volumes) {
+        total += volume;
+    }
+    return total;
+#endif
+}
+
+// Sum of price * volume across all levels.
+inline unsigned long Notional(const Levels &prices, const Levels &volumes) {
+#if defined(RTG_BOOK_KERNELS_AVX2)
+    return HorizontalSum(_mm256_mul_epu32(Load4(prices.data()),
+                                          Load4(volumes.data()))) +
+           prices[4] * volumes[4];
+#elif defined(RTG_BOOK_KERNELS_SSE4)
+    __m128i low = _mm_mul_epu32(Load2(prices.data()), Load2(volumes.data()));
+    __m128i high =
+        _mm_mul_epu32(Load2(prices.data() + 2), Load2(volumes.data() + 2));
+    return HorizontalSum(_mm_add_epi64(low, high)) + prices[4] * volumes[4];
+#else
+    unsigned long total = 0;
+    for (int i = 0; i < ReadyTraderGo::TOP_LEVEL_COUNT; i++) {
+        total += prices[i] * volumes[i];
+    }
+    return total;
+#endif
+}
+
+} // namespace BookKernels
+
+#endif // CPPREADY_TRADER_GO_BOOKKERNELS_H
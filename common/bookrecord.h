@@ -0,0 +1,66 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_BOOKRECORD_H
+#define CPPREADY_TRADER_GO_BOOKRECORD_H
+
+#include <cstdint>
+
+#include <ready_trader_go/types.h>
+
+// The layout of the market data recordings made by agg/ and read by the
+// converter and the replay engine.
+
+constexpr char BOOK_RECORD_MAGIC[8] = {'R', 'T', 'G', 'B', 'O', 'O', 'K', '1'};
+constexpr std::uint32_t BOOK_RECORD_VERSION = 3;
+
+// Written once at the start of every recording so readers can check they
+// understand the layout of the records that follow. The clock calibration
+// lets readers turn record timestamps into wall-clock time.
+struct BookFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t wallClockAtStart;
+    std::uint64_t monotonicAtStart;
+};
+
+enum class RecordKind : std::uint8_t { ORDER_BOOK, TRADE_TICKS };
+
+// One order book or trade ticks message as it was received by the
+// autotrader. Every record has the same size so a recording can be read (or
+// mapped) as a flat array.
+//
+// The timestamp is the monotonic capture time in nanoseconds (see
+// MonotonicClock) and the sequence number is the exchange's, so feed gaps
+// and reordering can be detected per instrument.
+struct BookRecord {
+    std::uint64_t sequenceNumber;
+    std::uint64_t timestamp;
+    std::uint8_t instrument;
+    RecordKind kind;
+    std::uint8_t reserved[6];
+    std::uint32_t askPrices[ReadyTraderGo::TOP_LEVEL_COUNT];
+    std::uint32_t askVolumes[ReadyTraderGo::TOP_LEVEL_COUNT];
+    std::uint32_t bidPrices[ReadyTraderGo::TOP_LEVEL_COUNT];
+    std::uint32_t bidVolumes[ReadyTraderGo::TOP_LEVEL_COUNT];
+};
+
+static_assert(sizeof(BookRecord) == 24 + 16 * ReadyTraderGo::TOP_LEVEL_COUNT,
+              "BookRecord must not contain hidden padding");
+
+#endif // CPPREADY_TRADER_GO_BOOKRECORD_H
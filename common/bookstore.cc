@@ -0,0 +1,350 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cstring>
+
+#include <ready_trader_go/error.h>
+
+#include "bookstore.h"
+
+using namespace ReadyTraderGo;
+
+static std::size_t ColumnWidth(std::size_t column) {
+    switch (static_cast<BookColumn>(column)) {
+    case BookColumn::SEQUENCE_NUMBER:
+    case BookColumn::TIMESTAMP:
+        return sizeof(std::uint64_t);
+    case BookColumn::INSTRUMENT:
+    case BookColumn::KIND:
+        return sizeof(std::uint8_t);
+    default:
+        return sizeof(std::uint32_t);
+    }
+}
+
+// The level of a price or volume array a column holds
+static std::uint32_t *LevelField(BookRecord &record, std::size_t column) {
+    std::size_t level =
+        column - static_cast<std::size_t>(BookColumn::ASK_PRICES);
+    std::uint32_t *arrays[] = {record.askPrices, record.askVolumes,
+                               record.bidPrices, record.bidVolumes};
+    return arrays[level / TOP_LEVEL_COUNT] + level % TOP_LEVEL_COUNT;
+}
+
+static std::uint64_t GetField(const BookRecord &record, std::size_t column) {
+    switch (static_cast<BookColumn>(column)) {
+    case BookColumn::SEQUENCE_NUMBER:
+        return record.sequenceNumber;
+    case BookColumn::TIMESTAMP:
+        return record.timestamp;
+    case BookColumn::INSTRUMENT:
+        return record.instrument;
+    case BookColumn::KIND:
+        return static_cast<std::uint64_t>(record.kind);
+    default:
+        return *LevelField(const_cast<BookRecord &>(record), column);
+    }
+}
+
+static void SetField(BookRecord &record, std::size_t column,
+                     std::uint64_t value) {
+    switch (static_cast<BookColumn>(column)) {
+    case BookColumn::SEQUENCE_NUMBER:
+        record.sequenceNumber = value;
+        break;
+    case BookColumn::TIMESTAMP:
+        record.timestamp = value;
+        break;
+    case BookColumn::INSTRUMENT:
+        record.instrument = static_cast<std::uint8_t>(value);
+        break;
+    case BookColumn::KIND:
+        record.kind = static_cast<RecordKind>(value);
+        break;
+    default:
+        *LevelField(record, column) = static_cast<std::uint32_t>(value);
+        break;
+    }
+}
+
+static void PutVarint(std::vector<unsigned char> &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static std::uint64_t GetVarint(const unsigned char *&in,
+                               const unsigned char *end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; in != end && shift < 64; shift += 7) {
+        unsigned char byte = *in++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+static std::uint64_t ZigZag(std::uint64_t delta) {
+    return (delta << 1) ^ (0 - (delta >> 63));
+}
+
+static std::uint64_t UnZigZag(std::uint64_t value) {
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+BookStoreWriter::BookStoreWriter(const std::string &filename,
+                                 const BookFileHeader &source, bool compress,
+                                 std::uint32_t blockRecords)
+    : mFilename(filename), mCompress(compress) {
+    if (blockRecords > MAX_BLOCK_RECORDS) {
+        throw ReadyTraderGoError("blocks of " + std::to_string(blockRecords) +
+                                 " records are too large for a store");
+    }
+    mFile.open(filename, std::ios::binary | std::ios::trunc);
+    if (!mFile) {
+        throw ReadyTraderGoError("unable to create " + filename);
+    }
+
+    std::memcpy(mHeader.magic, BOOK_STORE_MAGIC, sizeof(mHeader.magic));
+    mHeader.version = BOOK_STORE_VERSION;
+    mHeader.flags = compress ? BOOK_STORE_COMPRESSED : 0;
+    mHeader.source = source;
+    mHeader.blockRecords = std::max<std::uint32_t>(1, blockRecords);
+    mBlock.reserve(mHeader.blockRecords);
+
+    // The header is rewritten once the index has been
+    mFile.write(reinterpret_cast<const char *>(&mHeader), sizeof(mHeader));
+}
+
+BookStoreWriter::~BookStoreWriter() {
+    // Nobody is left to tell of a failure here; callers that need to know
+    // call Close() themselves
+    try {
+        Close();
+    } catch (const ReadyTraderGoError &) {
+    }
+}
+
+void BookStoreWriter::Append(const BookRecord &record) {
+    mBlock.push_back(record);
+    if (mBlock.size() == mHeader.blockRecords) {
+        WriteBlock();
+    }
+}
+
+void BookStoreWriter::WriteBlock() {
+    BookStoreIndexEntry entry{};
+    entry.offset = static_cast<std::uint64_t>(mFile.tellp());
+    entry.firstRecord = mHeader.recordCount;
+    entry.recordCount = static_cast<std::uint32_t>(mBlock.size());
+    entry.firstTimestamp = mBlock.front().timestamp;
+    entry.lastTimestamp = mBlock.back().timestamp;
+    for (const BookRecord &record : mBlock) {
+        auto stream = StreamIndex(record.kind,
+                                  static_cast<Instrument>(record.instrument));
+        if (stream < BOOK_STORE_STREAMS) {
+            mMaxSequence[stream] =
+                std::max(mMaxSequence[stream], record.sequenceNumber);
+        }
+    }
+    std::copy(std::begin(mMaxSequence), std::end(mMaxSequence),
+              entry.maxSequence);
+
+    mColumn.clear();
+    for (std::size_t column = 0; column < BOOK_COLUMN_COUNT; column++) {
+        entry.columnOffsets[column] =
+            static_cast<std::uint32_t>(mColumn.size());
+        std::uint64_t previous = 0;
+        for (const BookRecord &record : mBlock) {
+            std::uint64_t value = GetField(record, column);
+            if (mCompress) {
+                PutVarint(mColumn, ZigZag(value - previous));
+                previous = value;
+            } else {
+                auto bytes = reinterpret_cast<const unsigned char *>(&value);
+                mColumn.insert(mColumn.end(), bytes,
+                               bytes + ColumnWidth(column));
+            }
+        }
+        // Keep every column aligned for its type
+        mColumn.resize((mColumn.size() + 7) & ~std::size_t(7));
+    }
+    entry.columnOffsets[BOOK_COLUMN_COUNT] =
+        static_cast<std::uint32_t>(mColumn.size());
+
+    mFile.write(reinterpret_cast<const char *>(mColumn.data()),
+                mColumn.size());
+    mIndex.push_back(entry);
+    mHeader.recordCount += mBlock.size();
+    mHeader.blockCount++;
+    mBlock.clear();
+}
+
+void BookStoreWriter::Close() {
+    if (!mFile.is_open()) {
+        return;
+    }
+    if (!mBlock.empty()) {
+        WriteBlock();
+    }
+    mHeader.indexOffset = static_cast<std::uint64_t>(mFile.tellp());
+    mFile.write(reinterpret_cast<const char *>(mIndex.data()),
+                mIndex.size() * sizeof(BookStoreIndexEntry));
+    mFile.seekp(0);
+    mFile.write(reinterpret_cast<const char *>(&mHeader), sizeof(mHeader));
+    mFile.close();
+    // The stream's state is sticky, so this catches any failed write since
+    // the file was created
+    if (!mFile) {
+        throw ReadyTraderGoError("unable to write " + mFilename);
+    }
+}
+
+BookStoreReader::BookStoreReader(const std::string &filename) {
+    namespace bip = boost::interprocess;
+    try {
+        mFile = bip::file_mapping(filename.c_str(), bip::read_only);
+        mRegion = bip::mapped_region(mFile, bip::read_only);
+    } catch (const bip::interprocess_exception &) {
+        throw ReadyTraderGoError("unable to map " + filename);
+    }
+    mData = static_cast<const unsigned char *>(mRegion.get_address());
+    std::size_t size = mRegion.get_size();
+
+    mHeader = reinterpret_cast<const BookStoreHeader *>(mData);
+    if (size < sizeof(BookStoreHeader) ||
+        std::memcmp(mHeader->magic, BOOK_STORE_MAGIC,
+                    sizeof(mHeader->magic)) != 0) {
+        throw ReadyTraderGoError(filename + " is not a book store");
+    }
+    if (mHeader->version != BOOK_STORE_VERSION) {
+        throw ReadyTraderGoError(filename + " has unsupported version " +
+                                 std::to_string(mHeader->version));
+    }
+    if (mHeader->indexOffset > size ||
+        (size - mHeader->indexOffset) / sizeof(BookStoreIndexEntry) <
+            mHeader->blockCount) {
+        throw ReadyTraderGoError(filename + " is truncated");
+    }
+
+    mIndex = reinterpret_cast<const BookStoreIndexEntry *>(
+        mData + mHeader->indexOffset);
+    std::uint64_t records = 0;
+    for (std::size_t block = 0; block < BlockCount(); block++) {
+        const BookStoreIndexEntry &entry = mIndex[block];
+        if (entry.offset > mHeader->indexOffset ||
+            entry.columnOffsets[BOOK_COLUMN_COUNT] >
+                mHeader->indexOffset - entry.offset) {
+            throw ReadyTraderGoError(filename + " is truncated");
+        }
+        // Decode trusts the record count to size its output and each column
+        // to hold that many values: at least a byte each when compressed
+        if (entry.recordCount > mHeader->blockRecords ||
+            entry.firstRecord != records) {
+            throw ReadyTraderGoError(filename + " has a corrupt index");
+        }
+        for (std::size_t column = 0; column < BOOK_COLUMN_COUNT; column++) {
+            std::uint32_t start = entry.columnOffsets[column];
+            std::uint32_t end = entry.columnOffsets[column + 1];
+            std::uint64_t needed =
+                std::uint64_t(entry.recordCount) *
+                (Compressed() ? 1 : ColumnWidth(column));
+            if (end < start || end - start < needed) {
+                throw ReadyTraderGoError(filename + " has a corrupt index");
+            }
+        }
+        records += entry.recordCount;
+    }
+    if (records != mHeader->recordCount) {
+        throw ReadyTraderGoError(filename + " has a corrupt index");
+    }
+}
+
+std::size_t BookStoreReader::FindTime(std::uint64_t timestamp) const {
+    auto found = std::partition_point(
+        mIndex, mIndex + BlockCount(),
+        [timestamp](const BookStoreIndexEntry &entry) {
+            return entry.lastTimestamp < timestamp;
+        });
+    return found - mIndex;
+}
+
+std::size_t BookStoreReader::FindSequence(RecordKind kind,
+                                          Instrument instrument,
+                                          std::uint64_t sequenceNumber) const {
+    auto stream = StreamIndex(kind, instrument);
+    auto found = std::partition_point(
+        mIndex, mIndex + BlockCount(),
+        [stream, sequenceNumber](const BookStoreIndexEntry &entry) {
+            return entry.maxSequence[stream] < sequenceNumber;
+        });
+    return found - mIndex;
+}
+
+void BookStoreReader::Decode(std::size_t block,
+                             std::vector<BookRecord> &records) const {
+    const BookStoreIndexEntry &entry = mIndex[block];
+    const unsigned char *data = BlockData(block);
+    std::size_t first = records.size();
+    records.resize(first + entry.recordCount);
+    BookRecord *out = records.data() + first;
+    bool compressed = Compressed();
+
+    for (std::size_t column = 0; column < BOOK_COLUMN_COUNT; column++) {
+        const unsigned char *in = data + entry.columnOffsets[column];
+        const unsigned char *end = data + entry.columnOffsets[column + 1];
+        std::size_t width = ColumnWidth(column);
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < entry.recordCount; i++) {
+            if (compressed) {
+                value += UnZigZag(GetVarint(in, end));
+            } else {
+                value = 0;
+                std::memcpy(&value, in, width);
+                in += width;
+            }
+            SetField(out[i], column, value);
+        }
+    }
+}
+
+void BookStoreReader::Read(std::vector<BookRecord> &records, std::uint64_t from,
+                           std::uint64_t to) const {
+    for (std::size_t block = FindTime(from);
+         block < BlockCount() && mIndex[block].firstTimestamp < to; block++) {
+        std::size_t first = records.size();
+        Decode(block, records);
+        records.erase(std::remove_if(records.begin() + first, records.end(),
+                                     [from, to](const BookRecord &record) {
+                                         return record.timestamp < from ||
+                                                record.timestamp >= to;
+                                     }),
+                      records.end());
+    }
+}
+
+bool IsBookStore(const std::string &filename) {
+    char magic[sizeof(BOOK_STORE_MAGIC)] = {};
+    std::ifstream in(filename, std::ios::binary);
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, BOOK_STORE_MAGIC, sizeof(magic)) == 0;
+}
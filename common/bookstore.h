@@ -0,0 +1,233 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_BOOKSTORE_H
+#define CPPREADY_TRADER_GO_BOOKSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <ready_trader_go/types.h>
+
+#include "bookrecord.h"
+
+// A columnar layout for market data recordings, for reading long sessions
+// a window at a time.
+//
+// The records are stored in blocks of up to blockRecords consecutive
+// records. Within a block each field of BookRecord (and each level of the
+// price and volume arrays) is stored as its own column, so a reader that
+// wants only, say, the best bid reads only that column. An index at the
+// end of the file gives each block's time range and, for each of the four
+// streams (order books and trade ticks for each instrument), the highest
+// sequence number seen up to the end of the block, so a reader can find
+// the block holding any time or sequence number with a binary search.
+//
+// Columns are either stored plainly, as arrays that can be used straight
+// from the mapped file, or, when the store is compressed, as the zigzag
+// varint of each value's difference from the previous one (see
+// BookStoreWriter).
+//
+// Everything is little-endian, as written by the machine that made the
+// recording.
+
+constexpr char BOOK_STORE_MAGIC[8] = {'R', 'T', 'G', 'S', 'T', 'O', 'R', 'E'};
+constexpr std::uint32_t BOOK_STORE_VERSION = 1;
+
+constexpr std::size_t BOOK_STORE_STREAMS = 4;
+
+enum class BookColumn : std::uint8_t {
+    SEQUENCE_NUMBER,
+    TIMESTAMP,
+    INSTRUMENT,
+    KIND,
+    // Followed by one column per level for each of these
+    ASK_PRICES,
+    ASK_VOLUMES = ASK_PRICES + ReadyTraderGo::TOP_LEVEL_COUNT,
+    BID_PRICES = ASK_VOLUMES + ReadyTraderGo::TOP_LEVEL_COUNT,
+    BID_VOLUMES = BID_PRICES + ReadyTraderGo::TOP_LEVEL_COUNT,
+};
+
+constexpr std::size_t BOOK_COLUMN_COUNT =
+    static_cast<std::size_t>(BookColumn::BID_VOLUMES) +
+    ReadyTraderGo::TOP_LEVEL_COUNT;
+
+// The column for one level of ASK_PRICES, ASK_VOLUMES, BID_PRICES or
+// BID_VOLUMES
+constexpr BookColumn LevelColumn(BookColumn first, int level) {
+    return static_cast<BookColumn>(static_cast<int>(first) + level);
+}
+
+enum BookStoreFlags : std::uint32_t { BOOK_STORE_COMPRESSED = 1 };
+
+struct BookStoreHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    // The header of the recording the store was made from, for its clock
+    // calibration
+    BookFileHeader source;
+    std::uint64_t recordCount;
+    std::uint64_t blockCount;
+    std::uint32_t blockRecords;
+    std::uint32_t reserved;
+    // Where the index starts, from the start of the file
+    std::uint64_t indexOffset;
+};
+
+struct BookStoreIndexEntry {
+    // Where the block starts, from the start of the file
+    std::uint64_t offset;
+    // The number of records before this block
+    std::uint64_t firstRecord;
+    std::uint32_t recordCount;
+    std::uint32_t reserved;
+    std::uint64_t firstTimestamp;
+    std::uint64_t lastTimestamp;
+    // Per stream (see StreamIndex), the highest sequence number seen in this
+    // block or any before it, or zero if there has been none
+    std::uint64_t maxSequence[BOOK_STORE_STREAMS];
+    // Where each column starts, from the start of the block; the last
+    // entry is the block's size
+    std::uint32_t columnOffsets[BOOK_COLUMN_COUNT + 1];
+};
+
+// The stream a record belongs to; sequence numbers are only ordered within
+// a stream
+constexpr std::size_t StreamIndex(RecordKind kind,
+                                  ReadyTraderGo::Instrument instrument) {
+    return static_cast<std::size_t>(kind) * 2 +
+           static_cast<std::size_t>(instrument);
+}
+
+// Builds a store from records appended in the order they were captured.
+// Blocks are written as they fill and the index and header once Close() is
+// called, so a store is only readable once it has been closed.
+class BookStoreWriter {
+public:
+    static constexpr std::uint32_t DEFAULT_BLOCK_RECORDS = 4096;
+
+    // The most records a block can hold: its column offsets are 32 bits, so
+    // it must fit in 4 GiB even if every value takes the longest varint
+    static constexpr std::uint32_t MAX_BLOCK_RECORDS =
+        (UINT32_MAX - BOOK_COLUMN_COUNT * 7) / (BOOK_COLUMN_COUNT * 10);
+
+    // Throws ReadyTraderGoError if blockRecords is more than
+    // MAX_BLOCK_RECORDS or the file cannot be created.
+    BookStoreWriter(const std::string &filename, const BookFileHeader &source,
+                    bool compress,
+                    std::uint32_t blockRecords = DEFAULT_BLOCK_RECORDS);
+    ~BookStoreWriter();
+
+    BookStoreWriter(const BookStoreWriter &) = delete;
+    BookStoreWriter &operator=(const BookStoreWriter &) = delete;
+
+    void Append(const BookRecord &record);
+
+    // Writes the last block, the index and the header. Safe to call more
+    // than once. Throws ReadyTraderGoError if any part of the store could
+    // not be written; the destructor closes the store too, but cannot say
+    // so.
+    void Close();
+
+private:
+    void WriteBlock();
+
+    std::string mFilename;
+    std::ofstream mFile;
+    BookStoreHeader mHeader{};
+    bool mCompress;
+    std::vector<BookRecord> mBlock;
+    std::vector<BookStoreIndexEntry> mIndex;
+    std::uint64_t mMaxSequence[BOOK_STORE_STREAMS] = {};
+    std::vector<unsigned char> mColumn;
+};
+
+// Maps a store into memory and reads it, a block at a time.
+class BookStoreReader {
+public:
+    // Throws ReadyTraderGoError if the file cannot be mapped, is not a
+    // store this version can read, or its index does not fit its blocks.
+    explicit BookStoreReader(const std::string &filename);
+
+    const BookStoreHeader &Header() const { return *mHeader; }
+    bool Compressed() const {
+        return (mHeader->flags & BOOK_STORE_COMPRESSED) != 0;
+    }
+
+    std::size_t BlockCount() const { return mHeader->blockCount; }
+    const BookStoreIndexEntry &Block(std::size_t block) const {
+        return mIndex[block];
+    }
+
+    // The first block holding a record captured at or after the given
+    // monotonic time, or BlockCount() if there is none
+    std::size_t FindTime(std::uint64_t timestamp) const;
+
+    // The first block holding a record of the stream with at least the
+    // given sequence number, or BlockCount() if there is none
+    std::size_t FindSequence(RecordKind kind,
+                             ReadyTraderGo::Instrument instrument,
+                             std::uint64_t sequenceNumber) const;
+
+    // Appends the records of one block to the given vector.
+    void Decode(std::size_t block, std::vector<BookRecord> &records) const;
+
+    // Appends the records captured in [from, to) to the given vector,
+    // decoding only the blocks that hold them.
+    void Read(std::vector<BookRecord> &records, std::uint64_t from = 0,
+              std::uint64_t to =
+                  std::numeric_limits<std::uint64_t>::max()) const;
+
+    // A column of one block straight from the mapped file; only available
+    // (and otherwise nullptr) for stores that are not compressed. T must
+    // be the column's type: std::uint64_t for the sequence number and
+    // timestamp, std::uint8_t for the instrument and kind and std::uint32_t
+    // for the prices and volumes.
+    template <typename T>
+    const T *Column(std::size_t block, BookColumn column) const {
+        if (Compressed()) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T *>(
+            BlockData(block) +
+            mIndex[block].columnOffsets[static_cast<std::size_t>(column)]);
+    }
+
+private:
+    const unsigned char *BlockData(std::size_t block) const {
+        return mData + mIndex[block].offset;
+    }
+
+    boost::interprocess::file_mapping mFile;
+    boost::interprocess::mapped_region mRegion;
+    const unsigned char *mData;
+    const BookStoreHeader *mHeader;
+    const BookStoreIndexEntry *mIndex;
+};
+
+// Whether the file starts like a store rather than a flat recording
+bool IsBookStore(const std::string &filename);
+
+#endif // CPPREADY_TRADER_GO_BOOKSTORE_H
@@ -0,0 +1,106 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_MONOTONICCLOCK_H
+#define CPPREADY_TRADER_GO_MONOTONICCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(RTG_USE_TSC) && defined(__x86_64__) &&                            \
+    (defined(__GNUC__) || defined(__clang__))
+#define RTG_HAVE_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+// Nanosecond timestamps from a monotonic source.
+//
+// The clock is calibrated once against the wall clock when it is constructed,
+// so timestamps can be compared with each other cheaply and converted to wall
+// time afterwards without being affected by wall-clock adjustments.
+//
+// When built with RTG_USE_TSC on a CPU with an invariant TSC, the time stamp
+// counter is read directly and scaled to nanoseconds; otherwise
+// std::chrono::steady_clock is used.
+class MonotonicClock {
+public:
+    MonotonicClock() {
+        mWallAtStart = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count());
+        mMonoAtStart = SteadyNow();
+
+#ifdef RTG_HAVE_TSC
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) &&
+            (edx & (1u << 8)) != 0) {
+            auto tsc0 = __rdtsc();
+            auto mono0 = SteadyNow();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            auto tsc1 = __rdtsc();
+            auto mono1 = SteadyNow();
+            if (tsc1 > tsc0) {
+                mTscMultiplier = ((mono1 - mono0) << 32) / (tsc1 - tsc0);
+                mTscAtStart = tsc0;
+                mMonoAtStart = mono0;
+                mUseTsc = true;
+            }
+        }
+#endif
+    }
+
+    // Nanoseconds since an arbitrary, fixed point in the past.
+    std::uint64_t Now() const {
+#ifdef RTG_HAVE_TSC
+        if (mUseTsc) {
+            auto ticks = static_cast<unsigned __int128>(__rdtsc() - mTscAtStart);
+            return mMonoAtStart +
+                   static_cast<std::uint64_t>((ticks * mTscMultiplier) >> 32);
+        }
+#endif
+        return SteadyNow();
+    }
+
+    // Converts a timestamp returned by Now() into nanoseconds since the Unix
+    // epoch, using the calibration taken at construction.
+    std::uint64_t ToWallClock(std::uint64_t timestamp) const {
+        return mWallAtStart + (timestamp - mMonoAtStart);
+    }
+
+    std::uint64_t WallAtStart() const { return mWallAtStart; }
+    std::uint64_t MonotonicAtStart() const { return mMonoAtStart; }
+    bool UsesTsc() const { return mUseTsc; }
+
+private:
+    static std::uint64_t SteadyNow() {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    std::uint64_t mWallAtStart = 0;
+    std::uint64_t mMonoAtStart = 0;
+    std::uint64_t mTscAtStart = 0;
+    std::uint64_t mTscMultiplier = 0;
+    bool mUseTsc = false;
+};
+
+#endif // CPPREADY_TRADER_GO_MONOTONICCLOCK_H
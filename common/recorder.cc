@@ -0,0 +1,175 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <ready_trader_go/error.h>
+
+#include "recorder.h"
+
+static std::size_t RoundUpToPowerOfTwo(std::size_t n) {
+    std::size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+BookRecorder::BookRecorder(const std::string &filename,
+                           const MonotonicClock &clock, RecorderPool *pool,
+                           std::size_t capacity)
+    : mRing(RoundUpToPowerOfTwo(capacity)), mMask(mRing.size() - 1),
+      mPool(pool) {
+    mFile.open(filename, std::ios::binary | std::ios::trunc);
+    if (!mFile) {
+        throw ReadyTraderGo::ReadyTraderGoError("unable to open recording " +
+                                                filename);
+    }
+
+    BookFileHeader header{};
+    std::memcpy(header.magic, BOOK_RECORD_MAGIC, sizeof(header.magic));
+    header.version = BOOK_RECORD_VERSION;
+    header.recordSize = sizeof(BookRecord);
+    header.wallClockAtStart = clock.WallAtStart();
+    header.monotonicAtStart = clock.MonotonicAtStart();
+    mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!mFile) {
+        throw ReadyTraderGo::ReadyTraderGoError("unable to write recording " +
+                                                filename);
+    }
+
+    if (mPool != nullptr) {
+        mPool->Add(this);
+    } else {
+        mWriter = std::thread(&BookRecorder::WriterLoop, this);
+    }
+}
+
+BookRecorder::~BookRecorder() { Close(); }
+
+void BookRecorder::Close() {
+    mRunning.store(false, std::memory_order_release);
+    if (mWriter.joinable()) {
+        mWriter.join();
+    }
+    if (mPool != nullptr) {
+        // The pool no longer drains us, so write whatever is left here
+        mPool->Remove(this);
+        mPool = nullptr;
+        while (Drain() != 0) {
+        }
+    }
+    if (mFile.is_open()) {
+        mFile.close();
+    }
+}
+
+std::size_t BookRecorder::Drain() {
+    auto tail = mTail.load(std::memory_order_relaxed);
+    auto head = mHead.load(std::memory_order_acquire);
+    if (head == tail) {
+        // Only flush when the ring is idle, so that a busy feed is written
+        // out in as few large writes as possible.
+        if (mUnflushed != 0) {
+            Flush();
+        }
+        return 0;
+    }
+
+    auto begin = static_cast<std::size_t>(tail & mMask);
+    auto count = std::min<std::size_t>(head - tail, mRing.size() - begin);
+    // Once a write has failed the file is left alone; whatever follows is
+    // only counted
+    if (mFile) {
+        mFile.write(reinterpret_cast<const char *>(&mRing[begin]),
+                    count * sizeof(BookRecord));
+    }
+    if (mFile) {
+        mUnflushed += count;
+    } else {
+        mUnwritten.fetch_add(mUnflushed + count, std::memory_order_relaxed);
+        mUnflushed = 0;
+    }
+
+    mTail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+void BookRecorder::WriterLoop() {
+    while (true) {
+        // Read the running flag before draining so that nothing recorded
+        // before Close() was called can be missed.
+        bool running = mRunning.load(std::memory_order_acquire);
+        if (Drain() == 0) {
+            if (!running) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    Flush();
+}
+
+void BookRecorder::Flush() {
+    if (mFile) {
+        mFile.flush();
+    }
+    if (!mFile) {
+        mUnwritten.fetch_add(mUnflushed, std::memory_order_relaxed);
+    }
+    mUnflushed = 0;
+}
+
+RecorderPool::RecorderPool() {
+    mWriter = std::thread(&RecorderPool::WriterLoop, this);
+}
+
+RecorderPool::~RecorderPool() {
+    mRunning.store(false, std::memory_order_release);
+    if (mWriter.joinable()) {
+        mWriter.join();
+    }
+}
+
+void RecorderPool::Add(BookRecorder *recorder) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRecorders.push_back(recorder);
+}
+
+void RecorderPool::Remove(BookRecorder *recorder) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRecorders.erase(
+        std::remove(mRecorders.begin(), mRecorders.end(), recorder),
+        mRecorders.end());
+}
+
+void RecorderPool::WriterLoop() {
+    while (mRunning.load(std::memory_order_acquire)) {
+        std::size_t written = 0;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (BookRecorder *recorder : mRecorders) {
+                written += recorder->Drain();
+            }
+        }
+        if (written == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_RECORDER_H
+#define CPPREADY_TRADER_GO_RECORDER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+#include "bookrecord.h"
+#include "monotonicclock.h"
+
+// Records order book and trade ticks messages into a preallocated
+// single-producer, single-consumer ring. A background thread drains the ring
+// to disk in large contiguous writes, so the only work done on the
+// information callback is copying the message into the ring.
+//
+// If the writer falls so far behind that the ring is full, new updates are
+// dropped (and counted) rather than blocking the caller. Records that reach
+// the writer but cannot be written to the file (for example, because the
+// disk is full) are counted separately.
+//
+// A recorder normally has a writer thread of its own. Recorders made with a
+// RecorderPool are drained by the pool's thread instead, so one process can
+// record many sessions with a single writer.
+class RecorderPool;
+
+class BookRecorder {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+    // The capacity is rounded up to the next power of two. Without a pool
+    // the recorder starts a writer thread of its own; a pool must outlive
+    // the recorders that use it.
+    BookRecorder(const std::string &filename, const MonotonicClock &clock,
+                 RecorderPool *pool = nullptr,
+                 std::size_t capacity = DEFAULT_CAPACITY);
+    ~BookRecorder();
+
+    BookRecorder(const BookRecorder &) = delete;
+    BookRecorder &operator=(const BookRecorder &) = delete;
+
+    void Record(RecordKind kind, ReadyTraderGo::Instrument instrument,
+                unsigned long sequenceNumber, std::uint64_t timestamp,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &askPrices,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &askVolumes,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &bidPrices,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &bidVolumes) {
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) == mRing.size()) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        BookRecord &record = mRing[head & mMask];
+        record.sequenceNumber = sequenceNumber;
+        record.timestamp = timestamp;
+        record.instrument = static_cast<std::uint8_t>(instrument);
+        record.kind = kind;
+        for (int i = 0; i < ReadyTraderGo::TOP_LEVEL_COUNT; i++) {
+            record.askPrices[i] = static_cast<std::uint32_t>(askPrices[i]);
+            record.askVolumes[i] = static_cast<std::uint32_t>(askVolumes[i]);
+            record.bidPrices[i] = static_cast<std::uint32_t>(bidPrices[i]);
+            record.bidVolumes[i] = static_cast<std::uint32_t>(bidVolumes[i]);
+        }
+
+        mHead.store(head + 1, std::memory_order_release);
+    }
+
+    // Stops the writer thread once everything recorded so far has been
+    // written. Safe to call more than once.
+    void Close();
+
+    unsigned long DroppedCount() const {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+    // Records lost because writing them to the file failed
+    unsigned long UnwrittenCount() const {
+        return mUnwritten.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class RecorderPool;
+
+    void WriterLoop();
+
+    // Writes the largest contiguous run of records the ring holds and
+    // returns how many there were. Only ever called by one thread at a
+    // time.
+    std::size_t Drain();
+
+    // Flushes the file. If that fails, every record written since the last
+    // successful flush is counted as unwritten.
+    void Flush();
+
+    std::vector<BookRecord> mRing;
+    std::size_t mMask;
+
+    // Producer and consumer indices live on separate cache lines so the
+    // writer thread does not bounce the line the callback writes to.
+    alignas(64) std::atomic<std::uint64_t> mHead{0};
+    alignas(64) std::atomic<std::uint64_t> mTail{0};
+    alignas(64) std::atomic<unsigned long> mDropped{0};
+    std::atomic<unsigned long> mUnwritten{0};
+
+    std::atomic<bool> mRunning{true};
+    std::ofstream mFile;
+    // Records handed to the file since it was last flushed
+    std::size_t mUnflushed = 0;
+    std::thread mWriter;
+    RecorderPool *mPool = nullptr;
+};
+
+// One writer thread for any number of recorders, each still with its own
+// ring and file. The thread visits the recorders in turn, writing whatever
+// each has buffered, so a busy session never holds up the others for
+// longer than one write. Recording never takes the pool's lock; only
+// adding and closing a recorder do.
+class RecorderPool {
+public:
+    RecorderPool();
+    ~RecorderPool();
+
+    RecorderPool(const RecorderPool &) = delete;
+    RecorderPool &operator=(const RecorderPool &) = delete;
+
+private:
+    friend class BookRecorder;
+
+    void Add(BookRecorder *recorder);
+
+    // Once this returns the pool's thread will not touch the recorder again.
+    void Remove(BookRecorder *recorder);
+
+    void WriterLoop();
+
+    std::mutex mMutex;
+    std::vector<BookRecorder *> mRecorders;
+    std::atomic<bool> mRunning{true};
+    std::thread mWriter;
+};
+
+#endif // CPPREADY_TRADER_GO_RECORDER_H
@@ -0,0 +1,53 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_SEQUENCETRACKER_H
+#define CPPREADY_TRADER_GO_SEQUENCETRACKER_H
+
+#include <cstdint>
+
+// Tracks the sequence numbers seen on one stream of information messages,
+// counting the numbers skipped over and the messages that arrive out of
+// order.
+class SequenceTracker {
+public:
+    // Returns true if the message is newer than every one before it.
+    bool Update(std::uint64_t sequenceNumber) {
+        if (mCount++ != 0) {
+            if (sequenceNumber <= mLast) {
+                mReordered++;
+                return false;
+            }
+            mMissing += sequenceNumber - mLast - 1;
+        }
+        mLast = sequenceNumber;
+        return true;
+    }
+
+    std::uint64_t Last() const { return mLast; }
+    unsigned long Count() const { return mCount; }
+    unsigned long Missing() const { return mMissing; }
+    unsigned long Reordered() const { return mReordered; }
+
+private:
+    std::uint64_t mLast = 0;
+    unsigned long mCount = 0;
+    unsigned long mMissing = 0;
+    unsigned long mReordered = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_SEQUENCETRACKER_H
@@ -0,0 +1,20 @@
+# Selects the instruction set used by the kernels in bookkernels.h.
+#
+# NONE builds for the compiler's default target, NATIVE for the build
+# machine, and SSE4 or AVX2 for any CPU supporting that extension.
+set(RTG_SIMD "SSE4" CACHE STRING "Vector instructions to build for: NONE, SSE4, AVX2 or NATIVE")
+set_property(CACHE RTG_SIMD PROPERTY STRINGS NONE SSE4 AVX2 NATIVE)
+
+if(CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|amd64")
+    if(MSVC)
+        if(RTG_SIMD STREQUAL "AVX2" OR RTG_SIMD STREQUAL "NATIVE")
+            add_compile_options(/arch:AVX2)
+        endif()
+    elseif(RTG_SIMD STREQUAL "SSE4")
+        add_compile_options(-msse4.1)
+    elseif(RTG_SIMD STREQUAL "AVX2")
+        add_compile_options(-mavx2)
+    elseif(RTG_SIMD STREQUAL "NATIVE")
+        add_compile_options(-march=native)
+    endif()
+endif()
@@ -0,0 +1,40 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <fstream>
+
+#include <ready_trader_go/error.h>
+
+#include "accounting.h"
+
+void WriteAccountingSamples(const std::string &filename,
+                            const Accounting &accounting) {
+    std::ofstream out(filename);
+    out << "Time,EtfPosition,FuturePosition,Realized,Unrealized,Fees,"
+           "ProfitOrLoss\n";
+    for (const AccountingSample &sample : accounting.Samples()) {
+        out << sample.time << ',' << sample.etfPosition << ','
+            << sample.futurePosition << ',' << sample.realized << ','
+            << sample.unrealized << ',' << sample.fees << ','
+            << sample.realized + sample.unrealized - sample.fees << '\n';
+    }
+    out.close();
+    // The stream's state is sticky, so this catches any failed write
+    if (!out) {
+        throw ReadyTraderGo::ReadyTraderGoError("unable to write " + filename);
+    }
+}
@@ -0,0 +1,159 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_ACCOUNTING_H
+#define CPPREADY_TRADER_GO_ACCOUNTING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+// Position, cost and profit for one instrument, in cents. Trades that
+// reduce the position realize profit against the average cost; trades that
+// extend it add to the cost basis.
+struct PositionAccount {
+    long position = 0;
+    // What the open position cost, negative when it is short
+    long costBasis = 0;
+    long realized = 0;
+    // The price the open position is valued at
+    long mark = 0;
+
+    void Trade(long volume, long price) {
+        if (position == 0 || (position > 0) == (volume > 0)) {
+            position += volume;
+            costBasis += volume * price;
+            return;
+        }
+
+        long sign = position > 0 ? 1 : -1;
+        long closing = std::min(std::labs(volume), std::labs(position));
+        long closedBasis = costBasis * closing / std::labs(position);
+        realized += sign * closing * price - closedBasis;
+        costBasis -= closedBasis;
+        position -= sign * closing;
+
+        long opening = std::labs(volume) - closing;
+        position -= sign * opening;
+        costBasis -= sign * opening * price;
+    }
+
+    long AverageCost() const {
+        return position == 0 ? 0 : costBasis / position;
+    }
+    long Unrealized() const { return position * mark - costBasis; }
+};
+
+struct AccountingSample {
+    std::uint64_t time;
+    long etfPosition;
+    long futurePosition;
+    long realized;
+    long unrealized;
+    long fees;
+};
+
+// Keeps our positions, profit and fees up to date as fills arrive, in
+// constant time per event, and samples them once a second.
+//
+// Fees are positive when paid. The exchange only reports each order's
+// total fees, so an increase is counted as a taker fee and a decrease
+// (a rebate) as a maker fee.
+class Accounting {
+public:
+    static constexpr std::uint64_t SAMPLE_INTERVAL = 1'000'000'000;
+
+    // Enough for a match several times longer than usual; sampling stops
+    // once it is full, so nothing is allocated after construction.
+    static constexpr std::size_t MAX_SAMPLES = 4 * 60 * 60;
+
+    Accounting() { mSamples.reserve(MAX_SAMPLES); }
+
+    void EtfFill(ReadyTraderGo::Side side, unsigned long price,
+                 unsigned long volume) {
+        mEtf.Trade(side == ReadyTraderGo::Side::BUY ? (long)volume
+                                                    : -(long)volume,
+                   (long)price);
+    }
+
+    // The volume is signed: positive for futures bought.
+    void FutureFill(long volume, unsigned long price) {
+        mFuture.Trade(volume, (long)price);
+    }
+
+    void Fee(long fee) { (fee < 0 ? mMakerFees : mTakerFees) += fee; }
+
+    // Values the open positions at the given prices. A zero price leaves
+    // the previous mark in place.
+    void Mark(unsigned long etfPrice, unsigned long futurePrice) {
+        if (etfPrice != 0) {
+            mEtf.mark = (long)etfPrice;
+        }
+        if (futurePrice != 0) {
+            mFuture.mark = (long)futurePrice;
+        }
+    }
+
+    // Takes a sample if a second has passed since the last one.
+    void Sample(std::uint64_t now) {
+        if (now - mLastSample < SAMPLE_INTERVAL && !mSamples.empty()) {
+            return;
+        }
+        if (mSamples.size() < MAX_SAMPLES) {
+            mSamples.push_back({now, mEtf.position, mFuture.position,
+                                Realized(), Unrealized(), Fees()});
+        }
+        mLastSample = now;
+    }
+
+    const PositionAccount &Etf() const { return mEtf; }
+    const PositionAccount &Future() const { return mFuture; }
+
+    long MakerFees() const { return mMakerFees; }
+    long TakerFees() const { return mTakerFees; }
+    long Fees() const { return mMakerFees + mTakerFees; }
+
+    long Realized() const { return mEtf.realized + mFuture.realized; }
+    long Unrealized() const { return mEtf.Unrealized() + mFuture.Unrealized(); }
+    long ProfitOrLoss() const { return Realized() + Unrealized() - Fees(); }
+
+    // Our net delta in lots: the ETF and future move together, so a
+    // perfectly hedged book is flat.
+    long NetPosition() const { return mEtf.position + mFuture.position; }
+
+    const std::vector<AccountingSample> &Samples() const { return mSamples; }
+
+private:
+    PositionAccount mEtf;
+    PositionAccount mFuture;
+    long mMakerFees = 0;
+    long mTakerFees = 0;
+
+    std::vector<AccountingSample> mSamples;
+    std::uint64_t mLastSample = 0;
+};
+
+// Writes the samples as CSV, one row per second. Throws ReadyTraderGoError
+// if the file cannot be written.
+void WriteAccountingSamples(const std::string &filename,
+                            const Accounting &accounting);
+
+#endif // CPPREADY_TRADER_GO_ACCOUNTING_H
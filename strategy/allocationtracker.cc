@@ -0,0 +1,92 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <ready_trader_go/logging.h>
+
+#include "allocationtracker.h"
+
+using namespace ReadyTraderGo;
+
+#ifdef RTG_TRACK_ALLOCATIONS
+
+RTG_INLINE_GLOBAL_LOGGER_WITH_CHANNEL(LG_ALLOC, "ALLOC")
+
+static std::atomic<unsigned long> gTotalAllocations{0};
+static std::atomic<unsigned long> gHandlerAllocations{0};
+static std::atomic<unsigned long> gCallbacks{0};
+
+// Allocations made by this thread inside a handler scope but outside any
+// exempt scope.
+static thread_local unsigned long tTrackedAllocations = 0;
+static thread_local int tHandlerDepth = 0;
+static thread_local int tExemptDepth = 0;
+
+void *operator new(std::size_t size) {
+    gTotalAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (tHandlerDepth != 0 && tExemptDepth == 0) {
+        tTrackedAllocations++;
+    }
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+HandlerAllocationScope::HandlerAllocationScope(const char *handler)
+    : mHandler(handler), mAllocationsAtEntry(tTrackedAllocations) {
+    tHandlerDepth++;
+}
+
+HandlerAllocationScope::~HandlerAllocationScope() {
+    tHandlerDepth--;
+    auto allocations = tTrackedAllocations - mAllocationsAtEntry;
+    bool warm = gCallbacks.fetch_add(1, std::memory_order_relaxed) >=
+                ALLOCATION_WARM_UP_CALLBACKS;
+    // Nested scopes are reported by the outermost one.
+    if (tHandlerDepth != 0 || allocations == 0 || !warm) {
+        return;
+    }
+    gHandlerAllocations.fetch_add(allocations, std::memory_order_relaxed);
+    AllocationExemptScope exempt;
+    RLOG(LG_ALLOC, LogLevel::LL_ERROR)
+        << allocations << " heap allocation(s) in " << mHandler;
+}
+
+AllocationExemptScope::AllocationExemptScope() { tExemptDepth++; }
+AllocationExemptScope::~AllocationExemptScope() { tExemptDepth--; }
+
+unsigned long AllocationTracker::TotalCount() {
+    return gTotalAllocations.load(std::memory_order_relaxed);
+}
+
+unsigned long AllocationTracker::HandlerCount() {
+    return gHandlerAllocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+unsigned long AllocationTracker::TotalCount() { return 0; }
+unsigned long AllocationTracker::HandlerCount() { return 0; }
+
+#endif
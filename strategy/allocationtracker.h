@@ -0,0 +1,70 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_ALLOCATIONTRACKER_H
+#define CPPREADY_TRADER_GO_ALLOCATIONTRACKER_H
+
+// Checks that nothing on the callback paths allocates once the autotrader
+// has warmed up.
+//
+// Everything the strategy touches in a callback is fixed-size, and hot-path
+// log statements never format on the callback thread, so in the steady
+// state no callback should reach the heap. When built with
+// RTG_TRACK_ALLOCATIONS (see the CMake option, on by default in Debug
+// builds) the global operator new is replaced with one that counts, and
+// every allocation made inside a HandlerAllocationScope after the first
+// ALLOCATION_WARM_UP_CALLBACKS callbacks is reported, along with the name of
+// the handler. Without it the scopes compile to nothing.
+//
+// Rare paths that are allowed to allocate, such as error logging, are
+// wrapped in an AllocationExemptScope.
+constexpr unsigned long ALLOCATION_WARM_UP_CALLBACKS = 1000;
+
+class AllocationTracker {
+public:
+    // Every allocation made by the process, or zero when tracking is off.
+    static unsigned long TotalCount();
+
+    // Allocations reported inside handlers after warm-up.
+    static unsigned long HandlerCount();
+};
+
+class HandlerAllocationScope {
+public:
+#ifdef RTG_TRACK_ALLOCATIONS
+    explicit HandlerAllocationScope(const char *handler);
+    ~HandlerAllocationScope();
+
+private:
+    const char *mHandler;
+    unsigned long mAllocationsAtEntry;
+#else
+    explicit HandlerAllocationScope(const char *) {}
+#endif
+};
+
+class AllocationExemptScope {
+public:
+#ifdef RTG_TRACK_ALLOCATIONS
+    AllocationExemptScope();
+    ~AllocationExemptScope();
+#else
+    AllocationExemptScope() {}
+#endif
+};
+
+#endif // CPPREADY_TRADER_GO_ALLOCATIONTRACKER_H
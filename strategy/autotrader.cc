@@ -16,260 +16,323 @@
 //     License along with Ready Trader Go.  If not, see
 //     <https://www.gnu.org/licenses/>.
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
 
 #include <ready_trader_go/logging.h>
 
+#include "allocationtracker.h"
 #include "autotrader.h"
+#include "hotlog.h"
+#include "warmup.h"
 
 using namespace ReadyTraderGo;
 
 RTG_INLINE_GLOBAL_LOGGER_WITH_CHANNEL(LG_AT, "AUTO")
 
-constexpr int MARGIN_BASIS = 7;
-constexpr int MAX_ORDER_DEPTH = 5;
-constexpr int POSITION_LIMIT = 100;
-constexpr int TICK_SIZE_IN_CENTS = 100;
-constexpr int MIN_BID_NEARST_TICK = (MINIMUM_BID + TICK_SIZE_IN_CENTS) /
-                                    TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
-constexpr int MAX_ASK_NEAREST_TICK =
-    MAXIMUM_ASK / TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
-
-Order MAX_ORDER = {MAXIMUM_ASK, 0, 0, false};
-Order MIN_ORDER = {0, 0, 0, false};
-
-unsigned long MultiplyBasis(unsigned long n, long basis, bool ceil) {
-    unsigned long d = 10000 + basis;
-    return 100 * ((n * d) / 1000000);
-}
-
-AutoTrader::AutoTrader(boost::asio::io_context &context)
-    : BaseAutoTrader(context) {}
-
-void AutoTrader::DisconnectHandler() {
-    BaseAutoTrader::DisconnectHandler();
-    RLOG(LG_AT, LogLevel::LL_INFO) << "execution connection lost";
+// Synthetic order book updates for each instrument in the warm-up, a few
+// minutes of market at the usual tick interval
+constexpr unsigned long WARM_UP_UPDATES = 1000;
+
+// Strategies that take parameters get the ones in autotrader.json
+template <typename Logic>
+static Logic MakeLogic(ExecutionGateway &gateway,
+                       const ExchangeLimits &limits) {
+    if constexpr (std::is_constructible_v<Logic, ExecutionGateway &,
+                                          const ExchangeLimits &,
+                                          const StrategyParameters &>) {
+        StrategyParameters parameters;
+        parameters.sizing = LoadSizingCurveParameters("autotrader.json");
+        parameters.arbitrage = LoadArbitrageParameters("autotrader.json");
+        return Logic(gateway, limits, parameters);
+    } else {
+        return Logic(gateway, limits);
+    }
 }
 
-void AutoTrader::ErrorMessageHandler(unsigned long clientOrderId,
-                                     const std::string &errorMessage) {
-    RLOG(LG_AT, LogLevel::LL_INFO)
-        << "error with order " << clientOrderId << ": " << errorMessage;
-    if (clientOrderId != 0 && ((mAsks.count(clientOrderId) == 1) ||
-                               (mBids.count(clientOrderId) == 1))) {
-        OrderStatusMessageHandler(clientOrderId, 0, 0, 0);
+// Whether a strategy publishes live metrics
+template <typename Logic, typename = void>
+struct HasLiveMetrics : std::false_type {};
+template <typename Logic>
+struct HasLiveMetrics<
+    Logic, std::void_t<decltype(std::declval<const Logic &>().Metrics())>>
+    : std::true_type {};
+
+// Whether a strategy holds hedges back for a window
+template <typename Logic, typename = void>
+struct HasHedgeFlush : std::false_type {};
+template <typename Logic>
+struct HasHedgeFlush<
+    Logic, std::void_t<decltype(std::declval<Logic &>().FlushHedges())>>
+    : std::true_type {};
+
+// Whether a strategy wants its feed checked between messages
+template <typename Logic, typename = void>
+struct HasFeedCheck : std::false_type {};
+template <typename Logic>
+struct HasFeedCheck<Logic,
+                    std::void_t<decltype(std::declval<Logic &>().CheckFeed())>>
+    : std::true_type {};
+
+template <typename Logic, typename Recorder>
+BasicAutoTrader<Logic, Recorder>::BasicAutoTrader(
+    boost::asio::io_context &context)
+    : BaseAutoTrader(context), mIoContext(context),
+      mEventLoop(LoadEventLoopOptions("autotrader.json")),
+      mLimits(LoadExchangeLimits("exchange.json")), mFeedTimer(context),
+      mHedgeTimer(context), mRecording(mClock), mStrategy(MakeLogic<Logic>(*this, mLimits)) {
+#ifdef RTG_HOT_LOG_BINARY
+    HotLogRing::Instance().Start();
+#endif
+    if constexpr (HasLiveMetrics<Logic>::value) {
+        mMetrics.Start(mStrategy.Metrics(),
+                       LoadMetricsOptions("autotrader.json"));
     }
+    boost::asio::post(mIoContext, [this] { ConfigureEventLoop(); });
+    ScheduleFeedCheck();
 }
 
-void AutoTrader::HedgeFilledMessageHandler(unsigned long clientOrderId,
-                                           unsigned long price,
-                                           unsigned long volume) {
-    RLOG(LG_AT, LogLevel::LL_INFO)
-        << "hedge order " << clientOrderId << " filled for " << volume
-        << " lots at $" << price << " average price in cents";
+template <typename Logic, typename Recorder>
+BasicAutoTrader<Logic, Recorder>::~BasicAutoTrader() {
+#ifdef RTG_HOT_LOG_BINARY
+    HotLogRing::Instance().Stop();
+#endif
 }
 
-void AutoTrader::OrderBookMessageHandler(
-    Instrument instrument, unsigned long sequenceNumber,
-    const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
-    const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
-    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
-    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
-
-    RLOG(LG_AT, LogLevel::LL_INFO)
-        << "order book received for " << instrument << " instrument"
-        << ": ask prices: " << askPrices[0]
-        << "; ask volumes: " << askVolumes[0]
-        << "; bid prices: " << bidPrices[0]
-        << "; bid volumes: " << bidVolumes[0];
-
-    if (instrument != Instrument::FUTURE) {
-        return;
-    }
-
-    if (sequenceNumber <= mOrderBookSequence) {
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::DisconnectHandler() {
+    BaseAutoTrader::DisconnectHandler();
+    // Let the event loop finish once everything else has
+    mSpinning = false;
+    mFeedTimer.cancel();
+    mHedgeTimer.cancel();
+    mStrategy.DisconnectHandler();
+    mMetrics.Stop();
+    mRecording.Close();
+    if (mRecording.DroppedCount() != 0) {
         RLOG(LG_AT, LogLevel::LL_INFO)
-            << "received old order book information.";
-        return;
+            << "recorder dropped " << mRecording.DroppedCount()
+            << " market data updates";
     }
-    mOrderBookSequence = sequenceNumber;
-
-    unsigned long newAskPrice =
-        (askPrices[0] != 0) ? MultiplyBasis(askPrices[0], MARGIN_BASIS, true)
-                            : 0;
-    unsigned long newBidPrice =
-        (bidPrices[0] != 0) ? MultiplyBasis(bidPrices[0], -MARGIN_BASIS, true)
-                            : 0;
-
-    if (newAskPrice != 0)
-        RepriceSellOrders(newAskPrice);
-    if (newBidPrice != 0)
-        RepriceBuyOrders(newBidPrice);
+    if (mRecording.UnwrittenCount() != 0) {
+        RLOG(LG_AT, LogLevel::LL_ERROR)
+            << "recorder failed to write " << mRecording.UnwrittenCount()
+            << " market data updates";
+    }
+#ifdef RTG_TRACK_ALLOCATIONS
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << AllocationTracker::HandlerCount()
+        << " heap allocations were made in handlers after warm-up";
+#endif
 }
 
-void AutoTrader::RepriceSellOrders(unsigned long newAskPrice) {
-
-    unsigned long largestOrderId = 0;
-    Order *largestOrder = &MIN_ORDER;
-    bool askAlreadyExists = false;
-    for (auto &[orderId, order] : mAsks) {
-        if (order.cancelling) {
-            continue;
-        }
-        if (order.price == newAskPrice) {
-            askAlreadyExists = true;
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::ConfigureEventLoop() {
+    if (mEventLoop.core >= 0) {
+        if (PinCurrentThread(mEventLoop.core)) {
+            RLOG(LG_AT, LogLevel::LL_INFO)
+                << "callbacks pinned to core " << mEventLoop.core;
+        } else {
+            RLOG(LG_AT, LogLevel::LL_ERROR)
+                << "unable to pin callbacks to core " << mEventLoop.core;
         }
-        if (order.price < newAskPrice) {
-            SendCancelOrder(orderId);
-            order.cancelling = true;
-        } else if (order.price >= largestOrder->price) {
-            largestOrderId = orderId;
-            largestOrder = &order;
+    }
+    if (mEventLoop.warmUp) {
+        WarmUp();
+    }
+    if (mEventLoop.lockMemory) {
+        switch (LockMemory()) {
+        case MemoryLock::ALL:
+            RLOG(LG_AT, LogLevel::LL_INFO) << "memory locked";
+            break;
+        case MemoryLock::CURRENT:
+            RLOG(LG_AT, LogLevel::LL_INFO)
+                << "memory locked, apart from anything mapped from now on";
+            break;
+        case MemoryLock::NONE:
+            RLOG(LG_AT, LogLevel::LL_ERROR) << "unable to lock memory";
+            break;
         }
     }
-
-    if (largestOrderId != 0 && !largestOrder->cancelling &&
-        mETFOrderAskCount >= MAX_ORDER_DEPTH - 1) {
-        RLOG(LG_AT, LogLevel::LL_INFO)
-            << "cancelling sell order " << largestOrderId << " @ "
-            << largestOrder->price << " to make room for other orders";
-        largestOrder->cancelling = true;
-        SendCancelOrder(largestOrderId);
+    if (mEventLoop.busyPoll) {
+        RLOG(LG_AT, LogLevel::LL_INFO) << "busy-polling for events";
+        mSpinning = true;
+        Spin();
     }
+}
 
-    // TODO: maybe theres a quadratic function for this
-    long orderVolume = (mETFPosition + POSITION_LIMIT) / MAX_ORDER_DEPTH;
-
-    if (askAlreadyExists ||
-        (mETFPosition - mETFOrderPositionSell - orderVolume) <
-            -POSITION_LIMIT ||
-        mETFOrderAskCount >= MAX_ORDER_DEPTH) {
-        return;
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::WarmUp() {
+    // The copy's log output is bracketed by these two lines; its
+    // accounting, latencies and metrics are thrown away with it
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << "warming up on " << WARM_UP_UPDATES
+        << " synthetic updates, with nothing sent";
+    auto start = std::chrono::steady_clock::now();
+    WarmUpExchange exchange;
+    {
+        std::unique_ptr<Logic> logic(
+            new Logic(MakeLogic<Logic>(exchange, mLimits)));
+        exchange.Run(*logic, WARM_UP_UPDATES);
     }
-
-    auto orderId = mNextMessageId++;
-    SendInsertOrder(orderId, Side::SELL, newAskPrice, orderVolume,
-                    Lifespan::GOOD_FOR_DAY);
-
-    mETFOrderAskCount++;
-    mETFOrderPositionSell += orderVolume;
-
-    mAsks[orderId] = {newAskPrice, (unsigned long)orderVolume, 0};
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << "warmed up in " << elapsed << " us, answering "
+        << exchange.Messages() << " messages";
 }
 
-void AutoTrader::RepriceBuyOrders(unsigned long newBidPrice) {
-
-    unsigned long smallestOrderId = 0;
-    Order *smallestOrder = &MAX_ORDER;
-    bool bidAlreadyExists = false;
-    for (auto &[orderId, order] : mBids) {
-        if (order.cancelling) {
-            continue;
-        }
-        if (order.price == newBidPrice) {
-            bidAlreadyExists = true;
-        }
-        if (order.price > newBidPrice) {
-            SendCancelOrder(orderId);
-            order.cancelling = true;
-        } else if (order.price <= smallestOrder->price) {
-            smallestOrderId = orderId;
-            smallestOrder = &order;
-        }
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::Spin() {
+    // While a handler is queued the event loop checks for I/O without
+    // blocking, so re-posting this one keeps the thread awake.
+    if (mSpinning) {
+        boost::asio::post(mIoContext, [this] { Spin(); });
     }
+}
 
-    if (smallestOrderId != 0 && !smallestOrder->cancelling &&
-        mETFOrderBidCount >= MAX_ORDER_DEPTH - 1) {
-        smallestOrder->cancelling = true;
-        SendCancelOrder(smallestOrderId);
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::ScheduleFeedCheck() {
+    if constexpr (HasFeedCheck<Logic>::value) {
+        mFeedTimer.expires_after(
+            std::chrono::nanoseconds(mLimits.tickInterval));
+        mFeedTimer.async_wait([this](const boost::system::error_code &error) {
+            // Cancelled once the execution connection is lost
+            if (error) {
+                return;
+            }
+            {
+                HandlerAllocationScope scope("FeedCheck");
+                mStrategy.CheckFeed();
+            }
+            ScheduleFeedCheck();
+        });
     }
+}
 
-    long orderVolume = (POSITION_LIMIT - mETFPosition) / MAX_ORDER_DEPTH;
-
-    if (bidAlreadyExists ||
-        (mETFPosition + mETFOrderPositionBuy + orderVolume) > POSITION_LIMIT ||
-        mETFOrderBidCount >= MAX_ORDER_DEPTH) {
-        return;
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::ScheduleHedgeFlush() {
+    if constexpr (HasHedgeFlush<Logic>::value) {
+        std::uint64_t end = mStrategy.HedgeWindowEnd();
+        if (end == 0 || end == mHedgeWindowEnd) {
+            return;
+        }
+        mHedgeWindowEnd = end;
+        std::uint64_t now = mClock.Now();
+        mHedgeTimer.expires_after(
+            std::chrono::nanoseconds(end > now ? end - now : 0));
+        mHedgeTimer.async_wait([this](const boost::system::error_code &error) {
+            // Cancelled when a later window replaces this one, or once the
+            // execution connection is lost
+            if (error) {
+                return;
+            }
+            {
+                HandlerAllocationScope scope("HedgeFlush");
+                mStrategy.FlushHedges();
+            }
+            ScheduleHedgeFlush();
+        });
     }
-
-    auto orderId = mNextMessageId++;
-    SendInsertOrder(orderId, Side::BUY, newBidPrice, orderVolume,
-                    Lifespan::GOOD_FOR_DAY);
-
-    mETFOrderBidCount++;
-    mETFOrderPositionBuy += orderVolume;
-    mBids[orderId] = {newBidPrice, (unsigned long)orderVolume, 0};
 }
 
-void AutoTrader::OrderFilledMessageHandler(unsigned long clientOrderId,
-                                           unsigned long price,
-                                           unsigned long volume) {
-    RLOG(LG_AT, LogLevel::LL_INFO) << "order filled message " << clientOrderId
-                                   << " " << price << " " << volume;
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::ErrorMessageHandler(
+    unsigned long clientOrderId, const std::string &errorMessage) {
+    HandlerAllocationScope scope("ErrorMessageHandler");
+    mStrategy.ErrorMessageHandler(clientOrderId, errorMessage);
 }
 
-void AutoTrader::OrderStatusMessageHandler(unsigned long clientOrderId,
-                                           unsigned long fillVolume,
-                                           unsigned long remainingVolume,
-                                           signed long fees) {
-
-    RLOG(LG_AT, LogLevel::LL_INFO)
-        << "order status message received " << clientOrderId << " "
-        << fillVolume << " " << remainingVolume << " " << fees;
-
-    bool isSellOrder = mAsks.count(clientOrderId);
-    if (!isSellOrder && !mBids.count(clientOrderId)) {
-        RLOG(LG_AT, LogLevel::LL_INFO)
-            << "received order status for order we are not tracking. "
-               "id="
-            << clientOrderId;
-        return;
-    }
-
-    auto &sideMap = isSellOrder ? mAsks : mBids;
-    Order &order = sideMap[clientOrderId];
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::HedgeFilledMessageHandler(
+    unsigned long clientOrderId, unsigned long price, unsigned long volume) {
+    HandlerAllocationScope scope("HedgeFilledMessageHandler");
+    mStrategy.HedgeFilledMessageHandler(clientOrderId, price, volume);
+    ScheduleHedgeFlush();
+}
 
-    // Update our futures position to make sure we are correctly hedged
-    auto dFilled = fillVolume - order.filledVolume;
-    if (dFilled > 0) {
-        mETFPosition += isSellOrder ? -dFilled : dFilled;
-        SendHedgeOrder(mNextMessageId++, isSellOrder ? Side::BUY : Side::SELL,
-                       isSellOrder ? MAX_ASK_NEAREST_TICK : MIN_BID_NEARST_TICK,
-                       dFilled);
-    }
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::OrderBookMessageHandler(
+    Instrument instrument, unsigned long sequenceNumber,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
+    HandlerAllocationScope scope("OrderBookMessageHandler");
+    mRecording.Record(RecordKind::ORDER_BOOK, instrument, sequenceNumber,
+                      mClock.Now(), askPrices, askVolumes, bidPrices,
+                      bidVolumes);
+    mStrategy.OrderBookMessageHandler(instrument, sequenceNumber, askPrices,
+                                      askVolumes, bidPrices, bidVolumes);
+}
 
-    // Update the state
-    auto dRemaining = order.remainingVolume - remainingVolume;
-    if (isSellOrder) {
-        mETFOrderPositionSell -= dRemaining;
-    } else {
-        mETFOrderPositionBuy -= dRemaining;
-    }
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::OrderFilledMessageHandler(
+    unsigned long clientOrderId, unsigned long price, unsigned long volume) {
+    HandlerAllocationScope scope("OrderFilledMessageHandler");
+    mStrategy.OrderFilledMessageHandler(clientOrderId, price, volume);
+    ScheduleHedgeFlush();
+}
 
-    if (remainingVolume > 0) {
-        order.remainingVolume = remainingVolume;
-        order.filledVolume = fillVolume;
-    } else {
-        if (isSellOrder) {
-            mETFOrderAskCount--;
-        } else {
-            mETFOrderBidCount--;
-        }
-        sideMap.erase(clientOrderId);
-    }
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::OrderStatusMessageHandler(
+    unsigned long clientOrderId, unsigned long fillVolume,
+    unsigned long remainingVolume, signed long fees) {
+    HandlerAllocationScope scope("OrderStatusMessageHandler");
+    mStrategy.OrderStatusMessageHandler(clientOrderId, fillVolume,
+                                        remainingVolume, fees);
+    ScheduleHedgeFlush();
 }
 
-void AutoTrader::TradeTicksMessageHandler(
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::TradeTicksMessageHandler(
     Instrument instrument, unsigned long sequenceNumber,
     const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
     const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
     const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
     const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
-    RLOG(LG_AT, LogLevel::LL_INFO)
-        << "trade ticks received for " << instrument << " instrument"
-        << ": ask prices: " << askPrices[0]
-        << "; ask volumes: " << askVolumes[0]
-        << "; bid prices: " << bidPrices[0]
-        << "; bid volumes: " << bidVolumes[0];
+    HandlerAllocationScope scope("TradeTicksMessageHandler");
+    mRecording.Record(RecordKind::TRADE_TICKS, instrument, sequenceNumber,
+                      mClock.Now(), askPrices, askVolumes, bidPrices,
+                      bidVolumes);
+    mStrategy.TradeTicksMessageHandler(instrument, sequenceNumber, askPrices,
+                                       askVolumes, bidPrices, bidVolumes);
+}
+
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::SendAmendOrder(
+    unsigned long clientOrderId, unsigned long volume) {
+    BaseAutoTrader::SendAmendOrder(clientOrderId, volume);
+}
+
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::SendCancelOrder(
+    unsigned long clientOrderId) {
+    BaseAutoTrader::SendCancelOrder(clientOrderId);
 }
+
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::SendHedgeOrder(
+    unsigned long clientOrderId, Side side, unsigned long price,
+    unsigned long volume) {
+    BaseAutoTrader::SendHedgeOrder(clientOrderId, side, price, volume);
+}
+
+template <typename Logic, typename Recorder>
+void BasicAutoTrader<Logic, Recorder>::SendInsertOrder(
+    unsigned long clientOrderId, Side side, unsigned long price,
+    unsigned long volume, Lifespan lifespan) {
+    BaseAutoTrader::SendInsertOrder(clientOrderId, side, price, volume,
+                                    lifespan);
+}
+
+template class BasicAutoTrader<Strategy, NoRecording>;
+template class BasicAutoTrader<SingleLevelStrategy, NoRecording>;
+template class BasicAutoTrader<IdleStrategy, BookRecording>;
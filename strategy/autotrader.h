@@ -19,28 +19,40 @@
 #define CPPREADY_TRADER_GO_AUTOTRADER_H
 
 #include <array>
-#include <memory>
+#include <cstdint>
 #include <string>
-#include <unordered_set>
 
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <ready_trader_go/baseautotrader.h>
 #include <ready_trader_go/types.h>
 
-struct Order {
-
-    unsigned long price;
-
-    unsigned long remainingVolume;
-    unsigned long filledVolume;
-
-    bool cancelling = false;
-};
-
-class AutoTrader : public ReadyTraderGo::BaseAutoTrader {
+#include "eventloopoptions.h"
+#include "exchangelimits.h"
+#include "executiongateway.h"
+#include "idlestrategy.h"
+#include "livemetrics.h"
+#include "monotonicclock.h"
+#include "recordingpolicy.h"
+#include "singlelevelstrategy.h"
+#include "strategy.h"
+
+// Connects a strategy to the exchange: market data and execution messages
+// are passed straight on to it, and the orders it sends go out through the
+// base class.
+//
+// The Logic policy (a strategy) decides how we quote, size and hedge; the
+// Recorder policy decides what else happens to the market data (see
+// recordingpolicy.h).
+// Both are plain members called directly, so each variant compiles into
+// its own hot path with nothing left to decide at run time.
+template <typename Logic, typename Recorder>
+class BasicAutoTrader : public ReadyTraderGo::BaseAutoTrader,
+                        public ExecutionGateway {
 public:
-    explicit AutoTrader(boost::asio::io_context &context);
+    explicit BasicAutoTrader(boost::asio::io_context &context);
+    ~BasicAutoTrader() override;
 
     // Called when the execution connection is lost.
     void DisconnectHandler() override;
@@ -78,9 +90,6 @@ public:
         const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
             &bidVolumes) override;
 
-    void RepriceBuyOrders(unsigned long newBidPrice);
-    void RepriceSellOrders(unsigned long newAskPrice);
-
     // Called when one of your orders is filled, partially or fully.
     void OrderFilledMessageHandler(unsigned long clientOrderId,
                                    unsigned long price,
@@ -113,24 +122,72 @@ public:
         const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
             &bidVolumes) override;
 
-private:
-    unsigned long mNextMessageId = 1;
-    unsigned long mOrderBookSequence = 0;
-
-    // The change in the position we hold if all orders that have left our bot
-    // were filled either mETFPosition + mETFOrderPositionBuy > 100 or
-    // mETFPosition - mETFOrderPositionSell < 100 will disqualify our bot
-    signed long mETFOrderPositionSell = 0;
-    signed long mETFOrderPositionBuy = 0;
+    void SendAmendOrder(unsigned long clientOrderId,
+                        unsigned long volume) override;
+    void SendCancelOrder(unsigned long clientOrderId) override;
+    void SendHedgeOrder(unsigned long clientOrderId, ReadyTraderGo::Side side,
+                        unsigned long price, unsigned long volume) override;
+    void SendInsertOrder(unsigned long clientOrderId, ReadyTraderGo::Side side,
+                         unsigned long price, unsigned long volume,
+                         ReadyTraderGo::Lifespan lifespan) override;
 
-    unsigned int mETFOrderAskCount = 0;
-    unsigned int mETFOrderBidCount = 0;
+    std::uint64_t Now() const override { return mClock.Now(); }
 
-    signed long mETFPosition = 0;
-
-    // We track the state of our orders that are currently in the market
-    std::unordered_map<unsigned long, Order> mAsks;
-    std::unordered_map<unsigned long, Order> mBids;
+private:
+    // Applies the event loop options from the thread that runs the
+    // callbacks.
+    void ConfigureEventLoop();
+
+    // Runs a throwaway copy of the strategy against a WarmUpExchange.
+    void WarmUp();
+
+    // Keeps the event loop from ever waiting for work.
+    void Spin();
+
+    // Has the strategy check its feed once every tick interval, so that a
+    // feed that stops altogether is noticed without waiting for a message.
+    // Does nothing for strategies that have no CheckFeed().
+    void ScheduleFeedCheck();
+
+    // Has the strategy send a hedge held back by its aggregation window as
+    // soon as the window closes, if one has opened since the last call.
+    // Does nothing for strategies that have no FlushHedges().
+    void ScheduleHedgeFlush();
+
+    boost::asio::io_context &mIoContext;
+    EventLoopOptions mEventLoop;
+    bool mSpinning = false;
+
+    ExchangeLimits mLimits;
+    boost::asio::steady_timer mFeedTimer;
+    boost::asio::steady_timer mHedgeTimer;
+    // The end of the hedge window the timer was last armed for
+    std::uint64_t mHedgeWindowEnd = 0;
+
+    MonotonicClock mClock;
+    Recorder mRecording;
+    Logic mStrategy;
+
+    // Declared after the strategy, so it stops before the metrics it
+    // reads are destroyed
+    MetricsExporter mMetrics;
 };
 
+// The variants we build (see CMakeLists.txt), all instantiated in
+// autotrader.cc
+using LadderAutoTrader = BasicAutoTrader<Strategy, NoRecording>;
+using SingleLevelAutoTrader = BasicAutoTrader<SingleLevelStrategy, NoRecording>;
+using RecorderAutoTrader = BasicAutoTrader<IdleStrategy, BookRecording>;
+
+extern template class BasicAutoTrader<Strategy, NoRecording>;
+extern template class BasicAutoTrader<SingleLevelStrategy, NoRecording>;
+extern template class BasicAutoTrader<IdleStrategy, BookRecording>;
+
+// The variant main() runs; each executable chooses its own
+#ifdef RTG_AUTOTRADER_VARIANT
+using AutoTrader = RTG_AUTOTRADER_VARIANT;
+#else
+using AutoTrader = LadderAutoTrader;
+#endif
+
 #endif // CPPREADY_TRADER_GO_AUTOTRADER_H
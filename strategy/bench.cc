@@ -0,0 +1,510 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+// Microbenchmarks for the strategy's hot path, with every send going to a
+// stub gateway that acknowledges orders immediately.
+//
+// Usage: bench [-r RECORDING] [-b BASELINE] [-t PERCENT] [-n]
+//              [-w BASELINE]
+//
+//   -r  also time order book updates taken from a recording made by agg/
+//   -b  fail if any benchmark makes more heap allocations per operation
+//       than in BASELINE, or (where perf events are available on both
+//       sides) retires more than PERCENT (default 10) more instructions
+//       per operation
+//   -n  with -b, also fail if any benchmark is more than PERCENT slower
+//       per operation
+//   -w  write the results as a new baseline
+//
+// Each benchmark reports the median time per operation over several runs,
+// the instructions retired per operation (where perf events are available)
+// and the heap allocations per operation. A baseline is a text file with
+// one "name nanoseconds instructions allocations" line per benchmark, with
+// -1 for instructions that could not be counted.
+//
+// Allocations are exactly reproducible and instructions nearly so, so they
+// are what the checked-in baseline (unit_tests/data/bench_baseline.txt,
+// checked by ctest) gates on. Times only mean something on the machine
+// they were measured on; to gate on them, write a baseline before making a
+// change and check against it with -n afterwards.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <boost/log/core.hpp>
+
+#include <ready_trader_go/error.h>
+#include <ready_trader_go/types.h>
+
+#include "allocationtracker.h"
+#include "executiongateway.h"
+#include "replayexchange.h"
+#include "strategy.h"
+
+using namespace ReadyTraderGo;
+
+// With allocation tracking built in, its operator new does the counting.
+#ifdef RTG_TRACK_ALLOCATIONS
+static unsigned long AllocationCount() {
+    return AllocationTracker::TotalCount();
+}
+#else
+static std::atomic<unsigned long> gAllocations{0};
+
+static unsigned long AllocationCount() {
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+#endif
+
+template <typename T> inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Counts instructions retired by this thread, or reports -1 where perf
+// events are not available (or not permitted).
+class InstructionCounter {
+public:
+    InstructionCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        mFd = static_cast<int>(
+            syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~InstructionCounter() {
+#ifdef __linux__
+        if (mFd >= 0) {
+            close(mFd);
+        }
+#endif
+    }
+
+    void Start() {
+#ifdef __linux__
+        if (mFd >= 0) {
+            ioctl(mFd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(mFd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long Stop() {
+#ifdef __linux__
+        long long count = 0;
+        if (mFd >= 0) {
+            ioctl(mFd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(mFd, &count, sizeof(count)) == sizeof(count)) {
+                return static_cast<long>(count);
+            }
+        }
+#endif
+        return -1;
+    }
+
+private:
+    int mFd = -1;
+};
+
+// Acknowledges everything the strategy sends as the exchange would, once
+// the handler that sent it has returned, without ever filling anything.
+class BenchGateway : public ExecutionGateway {
+public:
+    void Attach(Strategy &strategy) { mStrategy = &strategy; }
+
+    void SendAmendOrder(unsigned long clientOrderId,
+                        unsigned long volume) override {
+        Queue({clientOrderId, volume});
+    }
+    void SendCancelOrder(unsigned long clientOrderId) override {
+        Queue({clientOrderId, 0});
+    }
+    void SendHedgeOrder(unsigned long, Side, unsigned long,
+                        unsigned long) override {}
+    void SendInsertOrder(unsigned long clientOrderId, Side, unsigned long,
+                         unsigned long volume, Lifespan) override {
+        Queue({clientOrderId, volume});
+    }
+
+    std::uint64_t Now() const override { return mNow; }
+    void Advance(std::uint64_t nanoseconds) { mNow += nanoseconds; }
+
+    void Deliver() {
+        for (std::size_t i = 0; i < mAckCount; i++) {
+            mStrategy->OrderStatusMessageHandler(mAcks[i].clientOrderId, 0,
+                                                 mAcks[i].remainingVolume, 0);
+        }
+        mAckCount = 0;
+    }
+
+private:
+    struct Ack {
+        unsigned long clientOrderId;
+        unsigned long remainingVolume;
+    };
+
+    void Queue(const Ack &ack) {
+        if (mAckCount < mAcks.size()) {
+            mAcks[mAckCount++] = ack;
+        }
+    }
+
+    Strategy *mStrategy = nullptr;
+    std::uint64_t mNow = 1;
+    std::array<Ack, 64> mAcks{};
+    std::size_t mAckCount = 0;
+};
+
+using Levels = std::array<unsigned long, TOP_LEVEL_COUNT>;
+
+struct BookUpdate {
+    Instrument instrument;
+    Levels askPrices;
+    Levels askVolumes;
+    Levels bidPrices;
+    Levels bidVolumes;
+};
+
+// A random walk of alternating future and ETF books around $100.
+static std::vector<BookUpdate> SyntheticBooks(std::size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<BookUpdate> books;
+    long mid = 10000;
+    for (std::size_t i = 0; i < count; i++) {
+        mid += static_cast<long>(rng() % 5) - 2;
+        BookUpdate book{i % 2 == 0 ? Instrument::FUTURE : Instrument::ETF};
+        for (int level = 0; level < TOP_LEVEL_COUNT; level++) {
+            book.askPrices[level] = (mid + 1 + level) * 100;
+            book.bidPrices[level] = (mid - 1 - level) * 100;
+            book.askVolumes[level] = 10 + rng() % 90;
+            book.bidVolumes[level] = 10 + rng() % 90;
+        }
+        books.push_back(book);
+    }
+    return books;
+}
+
+static std::vector<BookUpdate> RecordedBooks(const std::string &filename) {
+    BookFileHeader header{};
+    std::vector<BookUpdate> books;
+    for (const BookRecord &record : LoadRecording(filename, header)) {
+        if (record.kind != RecordKind::ORDER_BOOK) {
+            continue;
+        }
+        BookUpdate book{static_cast<Instrument>(record.instrument)};
+        std::copy(std::begin(record.askPrices), std::end(record.askPrices),
+                  book.askPrices.begin());
+        std::copy(std::begin(record.askVolumes), std::end(record.askVolumes),
+                  book.askVolumes.begin());
+        std::copy(std::begin(record.bidPrices), std::end(record.bidPrices),
+                  book.bidPrices.begin());
+        std::copy(std::begin(record.bidVolumes), std::end(record.bidVolumes),
+                  book.bidVolumes.begin());
+        books.push_back(book);
+    }
+    if (books.empty()) {
+        throw ReadyTraderGoError(filename + " has no order books");
+    }
+    return books;
+}
+
+struct BenchResult {
+    std::string name;
+    double nanosecondsPerOp;
+    double instructionsPerOp;
+    double allocationsPerOp;
+};
+
+// Runs body(count), which must perform count operations, enough times to
+// get a stable median.
+static BenchResult
+Measure(const std::string &name,
+        const std::function<void(std::size_t count)> &body) {
+    constexpr int RUNS = 7;
+    constexpr auto MIN_RUN_TIME = std::chrono::milliseconds(20);
+
+    std::size_t count = 1;
+    for (;;) {
+        auto start = std::chrono::steady_clock::now();
+        body(count);
+        if (std::chrono::steady_clock::now() - start >= MIN_RUN_TIME) {
+            break;
+        }
+        count *= 2;
+    }
+
+    InstructionCounter counter;
+    std::vector<double> times;
+    long instructions = -1;
+    unsigned long allocations = 0;
+    for (int run = 0; run < RUNS; run++) {
+        auto allocationsBefore = AllocationCount();
+        counter.Start();
+        auto start = std::chrono::steady_clock::now();
+        body(count);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        long runInstructions = counter.Stop();
+        allocations += AllocationCount() - allocationsBefore;
+        if (runInstructions >= 0 &&
+            (instructions < 0 || runInstructions < instructions)) {
+            instructions = runInstructions;
+        }
+        times.push_back(
+            std::chrono::duration<double, std::nano>(elapsed).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    return {name, times[RUNS / 2] / count,
+            instructions < 0 ? -1.0 : double(instructions) / count,
+            double(allocations) / (double(count) * RUNS)};
+}
+
+// Feeds books to a fresh strategy, one operation per book, with every
+// message acknowledged before the next book arrives.
+static BenchResult MeasureBooks(const std::string &name,
+                                const std::vector<BookUpdate> &books,
+                                const ExchangeLimits &limits) {
+    BenchGateway gateway;
+    Strategy strategy(gateway, limits);
+    gateway.Attach(strategy);
+    std::size_t next = 0;
+    unsigned long sequenceNumber = 0;
+    return Measure(name, [&](std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            const BookUpdate &book = books[next];
+            next = next + 1 == books.size() ? 0 : next + 1;
+            // Ticks are a quarter of a second apart in a match
+            gateway.Advance(250'000'000);
+            strategy.OrderBookMessageHandler(
+                book.instrument, ++sequenceNumber, book.askPrices,
+                book.askVolumes, book.bidPrices, book.bidVolumes);
+            gateway.Deliver();
+        }
+    });
+}
+
+static std::map<std::string, BenchResult>
+ReadBaseline(const std::string &name) {
+    std::ifstream in(name);
+    if (!in) {
+        throw ReadyTraderGoError("unable to open baseline " + name);
+    }
+    std::map<std::string, BenchResult> baseline;
+    BenchResult result;
+    while (in >> result.name >> result.nanosecondsPerOp >>
+           result.instructionsPerOp >> result.allocationsPerOp) {
+        baseline[result.name] = result;
+    }
+    return baseline;
+}
+
+// Compares one benchmark with its baseline, reporting every regression.
+// Returns true if there were any.
+static bool Regressed(const BenchResult &result, const BenchResult &baseline,
+                      double threshold, bool checkTime) {
+    bool regressed = false;
+    std::cerr << std::fixed << std::setprecision(3);
+    // The baseline is written with limited precision
+    if (result.allocationsPerOp > baseline.allocationsPerOp + 0.0005) {
+        std::cerr << result.name << " allocates more: "
+                  << baseline.allocationsPerOp << " -> "
+                  << result.allocationsPerOp << " allocs/op" << std::endl;
+        regressed = true;
+    }
+    std::cerr << std::setprecision(1);
+    if (result.instructionsPerOp >= 0 && baseline.instructionsPerOp > 0) {
+        double change =
+            (result.instructionsPerOp / baseline.instructionsPerOp - 1) * 100;
+        if (change > threshold) {
+            std::cerr << result.name << " regressed by " << change << "% ("
+                      << baseline.instructionsPerOp << " -> "
+                      << result.instructionsPerOp << " instr/op)"
+                      << std::endl;
+            regressed = true;
+        }
+    }
+    if (checkTime && baseline.nanosecondsPerOp > 0) {
+        double change =
+            (result.nanosecondsPerOp / baseline.nanosecondsPerOp - 1) * 100;
+        if (change > threshold) {
+            std::cerr << result.name << " regressed by " << change << "% ("
+                      << baseline.nanosecondsPerOp << " -> "
+                      << result.nanosecondsPerOp << " ns/op)" << std::endl;
+            regressed = true;
+        }
+    }
+    return regressed;
+}
+
+int main(int argc, char *argv[]) {
+    std::string recordingName;
+    std::string baselineName;
+    std::string newBaselineName;
+    double threshold = 10.0;
+    bool checkTime = false;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "-r") == 0 && hasValue) {
+            recordingName = argv[++i];
+        } else if (std::strcmp(argv[i], "-b") == 0 && hasValue) {
+            baselineName = argv[++i];
+        } else if (std::strcmp(argv[i], "-t") == 0 && hasValue) {
+            threshold = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "-n") == 0) {
+            checkTime = true;
+        } else if (std::strcmp(argv[i], "-w") == 0 && hasValue) {
+            newBaselineName = argv[++i];
+        } else {
+            std::cerr << "usage: bench [-r RECORDING] [-b BASELINE] "
+                         "[-t PERCENT] [-n] [-w BASELINE]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    boost::log::core::get()->set_logging_enabled(false);
+    ExchangeLimits limits;
+    std::vector<BenchResult> results;
+
+    try {
+        results.push_back(
+            Measure("multiply_basis", [](std::size_t count) {
+                unsigned long price = 10000;
+                for (std::size_t i = 0; i < count; i++) {
+                    DoNotOptimize(MultiplyBasis(price, 7, true));
+                    price += 100;
+                }
+            }));
+
+        auto synthetic = SyntheticBooks(1 << 12);
+        results.push_back(MeasureBooks("synthetic_book", synthetic, limits));
+
+        // The acknowledgement that follows every insert: a status for a
+        // resting order whose remaining volume has not changed.
+        {
+            BenchGateway gateway;
+            Strategy strategy(gateway, limits);
+            gateway.Attach(strategy);
+            const BookUpdate &future = synthetic[0];
+            strategy.OrderBookMessageHandler(
+                future.instrument, 1, future.askPrices, future.askVolumes,
+                future.bidPrices, future.bidVolumes);
+            gateway.Deliver();
+            results.push_back(
+                Measure("order_status_ack", [&](std::size_t count) {
+                    for (std::size_t i = 0; i < count; i++) {
+                        // Ids 1 and 2 are the first ask and bid inserted
+                        unsigned long id = 1 + (i & 1);
+                        strategy.OrderStatusMessageHandler(id, 0, 20, 0);
+                    }
+                }));
+        }
+
+        if (!recordingName.empty()) {
+            results.push_back(MeasureBooks(
+                "recorded_book", RecordedBooks(recordingName), limits));
+        }
+    } catch (const ReadyTraderGoError &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::left << std::setw(20) << "benchmark" << std::right
+              << std::setw(12) << "ns/op" << std::setw(14) << "instr/op"
+              << std::setw(12) << "allocs/op" << '\n'
+              << std::fixed;
+    for (const BenchResult &result : results) {
+        std::cout << std::left << std::setw(20) << result.name << std::right
+                  << std::setprecision(1) << std::setw(12)
+                  << result.nanosecondsPerOp << std::setw(14);
+        if (result.instructionsPerOp < 0) {
+            std::cout << "-";
+        } else {
+            std::cout << result.instructionsPerOp;
+        }
+        std::cout << std::setprecision(3) << std::setw(12)
+                  << result.allocationsPerOp << '\n';
+    }
+    std::cout.flush();
+
+    if (!newBaselineName.empty()) {
+        std::ofstream out(newBaselineName);
+        for (const BenchResult &result : results) {
+            out << result.name << ' ' << result.nanosecondsPerOp << ' '
+                << result.instructionsPerOp << ' ' << result.allocationsPerOp
+                << '\n';
+        }
+    }
+
+    if (baselineName.empty()) {
+        return EXIT_SUCCESS;
+    }
+
+    std::map<std::string, BenchResult> baseline;
+    try {
+        baseline = ReadBaseline(baselineName);
+    } catch (const ReadyTraderGoError &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    bool regressed = false;
+    for (const BenchResult &result : results) {
+        auto it = baseline.find(result.name);
+        if (it != baseline.end() &&
+            Regressed(result, it->second, threshold, checkTime)) {
+            regressed = true;
+        }
+    }
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
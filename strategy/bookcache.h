@@ -0,0 +1,173 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_BOOKCACHE_H
+#define CPPREADY_TRADER_GO_BOOKCACHE_H
+
+#include <array>
+
+#include <ready_trader_go/types.h>
+
+#include "bookkernels.h"
+
+using BookLevels = std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>;
+
+// Imbalances are reported in basis points of the total volume, so a value
+// of 10000 means all the volume is on the bid.
+constexpr long IMBALANCE_SCALE = 10000;
+
+// The last five levels of one instrument's book, kept as separate price and
+// volume arrays, along with signals derived from them. The signals are
+// computed once when the book changes so that readers never rescan levels.
+struct BookSnapshot {
+    alignas(32) BookLevels askPrices{};
+    alignas(32) BookLevels askVolumes{};
+    alignas(32) BookLevels bidPrices{};
+    alignas(32) BookLevels bidVolumes{};
+
+    unsigned long sequenceNumber = 0;
+
+    // Zero when the corresponding side of the book is empty.
+    unsigned long bestAsk = 0;
+    unsigned long bestBid = 0;
+
+    // Only meaningful when both sides of the book are present.
+    unsigned long spread = 0;
+    unsigned long midPrice = 0;
+    // Top-of-book mid weighted towards the side with less volume.
+    unsigned long microPrice = 0;
+    // Mid of the volume-weighted average ask and bid across all levels.
+    unsigned long weightedMid = 0;
+    // (bid volume - ask volume) / (bid volume + ask volume) at the touch.
+    long topImbalance = 0;
+    // Same as topImbalance, using the volume of all levels.
+    long depthImbalance = 0;
+
+    unsigned long askDepth = 0;
+    unsigned long bidDepth = 0;
+
+    bool HasBothSides() const { return bestAsk != 0 && bestBid != 0; }
+};
+
+// Holds the latest book for both instruments. Updates with a sequence
+// number no newer than the cached one are ignored.
+class BookCache {
+public:
+    // Returns false if the update was stale and has been ignored.
+    bool Update(ReadyTraderGo::Instrument instrument,
+                unsigned long sequenceNumber, const BookLevels &askPrices,
+                const BookLevels &askVolumes, const BookLevels &bidPrices,
+                const BookLevels &bidVolumes) {
+        BookSnapshot &book =
+            instrument == ReadyTraderGo::Instrument::ETF ? mEtf : mFuture;
+        if (sequenceNumber <= book.sequenceNumber) {
+            return false;
+        }
+        book.sequenceNumber = sequenceNumber;
+
+        if (askPrices == book.askPrices && askVolumes == book.askVolumes &&
+            bidPrices == book.bidPrices && bidVolumes == book.bidVolumes) {
+            return true;
+        }
+        book.askPrices = askPrices;
+        book.askVolumes = askVolumes;
+        book.bidPrices = bidPrices;
+        book.bidVolumes = bidVolumes;
+        Derive(book);
+        UpdateBasis();
+        return true;
+    }
+
+    const BookSnapshot &Etf() const { return mEtf; }
+    const BookSnapshot &Future() const { return mFuture; }
+    const BookSnapshot &Get(ReadyTraderGo::Instrument instrument) const {
+        return instrument == ReadyTraderGo::Instrument::ETF ? mEtf : mFuture;
+    }
+
+    // ETF mid minus future mid in cents, or zero unless both books have
+    // both sides.
+    long Basis() const { return mBasis; }
+
+    // The basis in basis points of the future mid.
+    long BasisBps() const { return mBasisBps; }
+
+private:
+    static long Imbalance(unsigned long bidVolume, unsigned long askVolume) {
+        unsigned long total = bidVolume + askVolume;
+        if (total == 0) {
+            return 0;
+        }
+        return (static_cast<long>(bidVolume) - static_cast<long>(askVolume)) *
+               IMBALANCE_SCALE / static_cast<long>(total);
+    }
+
+    static void Derive(BookSnapshot &book) {
+        book.bestAsk = book.askPrices[0];
+        book.bestBid = book.bidPrices[0];
+
+        book.askDepth = BookKernels::TotalVolume(book.askVolumes);
+        book.bidDepth = BookKernels::TotalVolume(book.bidVolumes);
+
+        book.topImbalance = Imbalance(book.bidVolumes[0], book.askVolumes[0]);
+        book.depthImbalance = Imbalance(book.bidDepth, book.askDepth);
+
+        if (!book.HasBothSides()) {
+            book.spread = 0;
+            book.midPrice = 0;
+            book.microPrice = 0;
+            book.weightedMid = 0;
+            return;
+        }
+
+        book.spread = book.bestAsk - book.bestBid;
+        book.midPrice = (book.bestAsk + book.bestBid) / 2;
+
+        unsigned long topVolume = book.askVolumes[0] + book.bidVolumes[0];
+        book.microPrice = topVolume == 0
+                              ? book.midPrice
+                              : (book.bestAsk * book.bidVolumes[0] +
+                                 book.bestBid * book.askVolumes[0]) /
+                                    topVolume;
+
+        book.weightedMid =
+            (book.askDepth == 0 || book.bidDepth == 0)
+                ? book.midPrice
+                : (BookKernels::Notional(book.askPrices, book.askVolumes) /
+                       book.askDepth +
+                   BookKernels::Notional(book.bidPrices, book.bidVolumes) /
+                       book.bidDepth) /
+                      2;
+    }
+
+    void UpdateBasis() {
+        if (!mEtf.HasBothSides() || !mFuture.HasBothSides()) {
+            mBasis = 0;
+            mBasisBps = 0;
+            return;
+        }
+        mBasis = static_cast<long>(mEtf.midPrice) -
+                 static_cast<long>(mFuture.midPrice);
+        mBasisBps = mBasis * 10000 / static_cast<long>(mFuture.midPrice);
+    }
+
+    BookSnapshot mEtf;
+    BookSnapshot mFuture;
+    long mBasis = 0;
+    long mBasisBps = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_BOOKCACHE_H
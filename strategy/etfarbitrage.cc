@@ -0,0 +1,50 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "etfarbitrage.h"
+
+ArbitrageParameters LoadArbitrageParameters(const std::string &filename) {
+    ArbitrageParameters parameters;
+
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::read_json(filename, tree);
+    } catch (const boost::property_tree::json_parser_error &) {
+        return parameters;
+    }
+
+    parameters.enabled = tree.get("Arbitrage.Enabled", parameters.enabled);
+    parameters.thresholdBasis =
+        tree.get("Arbitrage.ThresholdBasis", parameters.thresholdBasis);
+    parameters.volume = tree.get("Arbitrage.Volume", parameters.volume);
+
+    return parameters;
+}
+
+EtfArbitrage::EtfArbitrage(const ArbitrageParameters &parameters,
+                           const ExchangeLimits &limits)
+    : mEnabled(parameters.enabled && parameters.volume != 0),
+      mHurdlePpm(std::lround(std::max(0.0, limits.takerFee) * PPM) +
+                 std::max(0l, parameters.thresholdBasis) * (PPM / 10000)),
+      mClampPpm(std::lround(std::max(0.0, limits.etfClamp) * PPM)),
+      mVolume(parameters.volume) {}
@@ -0,0 +1,174 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_ETFARBITRAGE_H
+#define CPPREADY_TRADER_GO_ETFARBITRAGE_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include <ready_trader_go/types.h>
+
+#include "bookcache.h"
+#include "bookkernels.h"
+#include "exchangelimits.h"
+
+// When to take liquidity on the ETF because it has come apart from the
+// future. Read from the optional "Arbitrage" block of autotrader.json:
+//
+//     "Arbitrage": {
+//       "Enabled": true,
+//       "ThresholdBasis": 1,
+//       "Volume": 10
+//     }
+//
+// The ETF is taken, with a fill-and-kill order at its touch, when doing so
+// and hedging in the future is expected to make more than the taker fee
+// plus ThresholdBasis basis points (never less than zero). Each take is
+// for at most Volume lots.
+struct ArbitrageParameters {
+    bool enabled = false;
+    long thresholdBasis = 1;
+    unsigned long volume = 10;
+};
+
+ArbitrageParameters LoadArbitrageParameters(const std::string &filename);
+
+// A take the arbitrage wants: volume is zero when there is none.
+struct ArbitrageTake {
+    ReadyTraderGo::Side side;
+    unsigned long price;
+    unsigned long volume;
+};
+
+// Keeps an estimate of where the ETF trades relative to the future (the
+// basis, ETF minus future, in cents) and decides when the books have moved
+// far enough from it to take the ETF and hedge.
+//
+// The estimate is a decayed average of the mid-to-mid basis of each pair of
+// books and of the basis at which each ETF trade ticks message traded,
+// trades counting for more. The exchange keeps the ETF within EtfClamp of
+// the future, so samples are limited to that band and no take is priced
+// outside it.
+//
+// Buying the ETF's ask and selling the future's bid makes, per lot, the
+// future's bid plus the basis minus the ETF's ask, once the basis returns
+// to normal; selling is the mirror image. Deciding is integer arithmetic
+// with no branches, so it costs the same on every update.
+class EtfArbitrage {
+public:
+    EtfArbitrage(const ArbitrageParameters &parameters,
+                 const ExchangeLimits &limits);
+
+    bool Enabled() const { return mEnabled; }
+
+    // Folds the latest pair of books into the estimate.
+    void UpdateBooks(const BookCache &books) {
+        if (!books.Etf().HasBothSides() || !books.Future().HasBothSides()) {
+            return;
+        }
+        Sample(static_cast<long>(books.Etf().midPrice),
+               books.Future().midPrice, BOOK_WEIGHT);
+    }
+
+    // Folds an ETF trade ticks message into the estimate.
+    void UpdateTrades(const BookLevels &askPrices, const BookLevels &askVolumes,
+                      const BookLevels &bidPrices, const BookLevels &bidVolumes,
+                      const BookSnapshot &future) {
+        unsigned long volume = BookKernels::TotalVolume(askVolumes) +
+                               BookKernels::TotalVolume(bidVolumes);
+        if (volume == 0 || !future.HasBothSides()) {
+            return;
+        }
+        unsigned long vwap = (BookKernels::Notional(askPrices, askVolumes) +
+                              BookKernels::Notional(bidPrices, bidVolumes)) /
+                             volume;
+        Sample(static_cast<long>(vwap), future.midPrice, TRADE_WEIGHT);
+    }
+
+    // The estimated basis in cents, zero before the first sample.
+    long Basis() const { return mBasis / BASIS_SCALE; }
+
+    // Returns the take, if any, that the given books are worth. The rooms
+    // are how many lots we may buy and sell before reaching the position
+    // limit, counting orders already in the market.
+    ArbitrageTake Decide(const BookSnapshot &etf, const BookSnapshot &future,
+                         long buyRoom, long sellRoom) const {
+        long etfAsk = static_cast<long>(etf.bestAsk);
+        long etfBid = static_cast<long>(etf.bestBid);
+        long futureAsk = static_cast<long>(future.bestAsk);
+        long futureBid = static_cast<long>(future.bestBid);
+        long futureMid = static_cast<long>(future.midPrice);
+        long basis = Basis();
+
+        long buyEdge = futureBid + basis - etfAsk;
+        long sellEdge = etfBid - basis - futureAsk;
+        long band = mClampPpm * futureMid;
+
+        bool ready = mEnabled & etf.HasBothSides() & future.HasBothSides();
+        bool buy = ready & (buyEdge * PPM > mHurdlePpm * etfAsk) &
+                   (std::labs(etfAsk - futureMid) * PPM <= band);
+        bool sell = ready & (sellEdge * PPM > mHurdlePpm * etfBid) &
+                    (std::labs(etfBid - futureMid) * PPM <= band);
+
+        unsigned long buyVolume =
+            buy * std::min({etf.askVolumes[0], future.bidVolumes[0], mVolume,
+                            static_cast<unsigned long>(std::max(0l, buyRoom))});
+        unsigned long sellVolume =
+            sell *
+            std::min({etf.bidVolumes[0], future.askVolumes[0], mVolume,
+                      static_cast<unsigned long>(std::max(0l, sellRoom))});
+
+        // The two edges add up to minus both spreads, so with a hurdle of
+        // at least zero only one side can be worth taking
+        return {sellVolume != 0 ? ReadyTraderGo::Side::SELL
+                                : ReadyTraderGo::Side::BUY,
+                static_cast<unsigned long>(sellVolume != 0 ? etfBid : etfAsk),
+                buyVolume + sellVolume};
+    }
+
+private:
+    // Thresholds and the clamp are kept in parts per million of a price
+    static constexpr long PPM = 1'000'000;
+
+    // The estimate carries this many fractional bits
+    static constexpr long BASIS_SCALE = 1 << 8;
+
+    // Each sample moves the estimate this fraction of the way towards it
+    static constexpr long BOOK_WEIGHT = 16;
+    static constexpr long TRADE_WEIGHT = 8;
+
+    void Sample(long etfPrice, unsigned long futureMid, long weight) {
+        long clamp = mClampPpm * static_cast<long>(futureMid) / PPM;
+        long sample =
+            std::clamp(etfPrice - static_cast<long>(futureMid), -clamp, clamp) *
+            BASIS_SCALE;
+        mBasis = mSampled ? mBasis + (sample - mBasis) / weight : sample;
+        mSampled = true;
+    }
+
+    bool mEnabled;
+    long mHurdlePpm;
+    long mClampPpm;
+    unsigned long mVolume;
+
+    long mBasis = 0;
+    bool mSampled = false;
+};
+
+#endif // CPPREADY_TRADER_GO_ETFARBITRAGE_H
@@ -0,0 +1,77 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "eventloopoptions.h"
+
+EventLoopOptions LoadEventLoopOptions(const std::string &filename) {
+    EventLoopOptions options;
+
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::read_json(filename, tree);
+    } catch (const boost::property_tree::json_parser_error &) {
+        return options;
+    }
+
+    options.core = tree.get("EventLoop.Core", options.core);
+    options.busyPoll = tree.get("EventLoop.BusyPoll", options.busyPoll);
+    options.warmUp = tree.get("EventLoop.WarmUp", options.warmUp);
+    options.lockMemory = tree.get("EventLoop.LockMemory", options.lockMemory);
+
+    return options;
+}
+
+bool PinCurrentThread(int core) {
+#ifdef __linux__
+    if (core < 0 || core >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+MemoryLock LockMemory() {
+#ifdef __linux__
+    // Locking future mappings under a finite limit would make allocations
+    // fail once it is reached, so then only what is mapped now is locked
+    rlimit limit{};
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 &&
+        limit.rlim_cur == RLIM_INFINITY &&
+        mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+        return MemoryLock::ALL;
+    }
+    return mlockall(MCL_CURRENT) == 0 ? MemoryLock::CURRENT : MemoryLock::NONE;
+#else
+    return MemoryLock::NONE;
+#endif
+}
@@ -0,0 +1,64 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_EVENTLOOPOPTIONS_H
+#define CPPREADY_TRADER_GO_EVENTLOOPOPTIONS_H
+
+#include <string>
+
+// The optional "EventLoop" block of autotrader.json:
+//
+//     "EventLoop": {
+//       "Core": 3,
+//       "BusyPoll": true,
+//       "WarmUp": true,
+//       "LockMemory": true
+//     }
+//
+// Core pins the thread that runs the callbacks to one CPU (-1 leaves it
+// to the scheduler). BusyPoll keeps that thread spinning instead of
+// sleeping between events, so an event never waits for the thread to be
+// woken up. It should only be used with a core to spare. WarmUp runs a
+// throwaway copy of the strategy against synthetic books before the market
+// opens (see WarmUpExchange), so the first real event does not pay for
+// cold caches and untouched pages.
+// LockMemory keeps everything the process has mapped in RAM, and with an
+// unlimited RLIMIT_MEMLOCK whatever it maps later too.
+struct EventLoopOptions {
+    int core = -1;
+    bool busyPoll = false;
+    bool warmUp = false;
+    bool lockMemory = false;
+};
+
+// Reads the options from the given autotrader configuration. Anything
+// missing keeps its default.
+EventLoopOptions LoadEventLoopOptions(const std::string &filename);
+
+// Pins the calling thread to the given core. Returns false if that is not
+// possible on this platform or the core does not exist.
+bool PinCurrentThread(int core);
+
+enum class MemoryLock { NONE, CURRENT, ALL };
+
+// Locks the process's memory, faulting in every page it has mapped, and
+// its future mappings as well if the lock limit allows it. Returns what was
+// locked: NONE if locking is not possible on this platform or not
+// permitted.
+MemoryLock LockMemory();
+
+#endif // CPPREADY_TRADER_GO_EVENTLOOPOPTIONS_H
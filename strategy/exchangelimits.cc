@@ -0,0 +1,60 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "exchangelimits.h"
+
+ExchangeLimits LoadExchangeLimits(const std::string &filename) {
+    ExchangeLimits limits;
+
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::read_json(filename, tree);
+    } catch (const boost::property_tree::json_parser_error &) {
+        return limits;
+    }
+
+    limits.activeOrderCountLimit = tree.get(
+        "Limits.ActiveOrderCountLimit", limits.activeOrderCountLimit);
+    limits.activeVolumeLimit =
+        tree.get("Limits.ActiveVolumeLimit", limits.activeVolumeLimit);
+    limits.messageFrequencyLimit = tree.get("Limits.MessageFrequencyLimit",
+                                            limits.messageFrequencyLimit);
+    limits.positionLimit =
+        tree.get("Limits.PositionLimit", limits.positionLimit);
+    // The engine runs Speed times faster than real time, so both of its
+    // intervals are shorter by that much; a Speed that is not positive is
+    // ignored
+    double speed = tree.get("Engine.Speed", 1.0);
+    if (!(speed > 0)) {
+        speed = 1.0;
+    }
+    limits.messageFrequencyInterval = static_cast<std::uint64_t>(
+        tree.get("Limits.MessageFrequencyInterval",
+                 limits.messageFrequencyInterval / 1e9) *
+        1e9 / speed);
+    limits.tickInterval = static_cast<std::uint64_t>(
+        tree.get("Engine.TickInterval", limits.tickInterval / 1e9) * 1e9 /
+        speed);
+    limits.makerFee = tree.get("Fees.Maker", limits.makerFee);
+    limits.takerFee = tree.get("Fees.Taker", limits.takerFee);
+    limits.etfClamp = tree.get("Instrument.EtfClamp", limits.etfClamp);
+
+    return limits;
+}
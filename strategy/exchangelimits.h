@@ -0,0 +1,50 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_EXCHANGELIMITS_H
+#define CPPREADY_TRADER_GO_EXCHANGELIMITS_H
+
+#include <cstdint>
+#include <string>
+
+// The "Limits" block of the simulator's exchange.json, the engine's tick
+// interval, the fees and the ETF clamp. The defaults are the values
+// the competition runs with.
+struct ExchangeLimits {
+    unsigned long activeOrderCountLimit = 10;
+    unsigned long activeVolumeLimit = 200;
+    // The window the message limit applies to, in real time like the tick
+    // interval
+    std::uint64_t messageFrequencyInterval = 1000000000; // nanoseconds
+    unsigned long messageFrequencyLimit = 50;
+    long positionLimit = 100;
+    // How often the exchange publishes order books, in real time: the
+    // engine's TickInterval divided by its Speed
+    std::uint64_t tickInterval = 250000000; // nanoseconds
+    // The fractions of the notional charged for adding and taking liquidity
+    // on the ETF; a negative fee is a rebate
+    double makerFee = -0.0001;
+    double takerFee = 0.0002;
+    // The ETF trades within this fraction of the future's price
+    double etfClamp = 0.002;
+};
+
+// Reads the limits from the given exchange configuration. Any value (or the
+// whole file) that is missing keeps its default.
+ExchangeLimits LoadExchangeLimits(const std::string &filename);
+
+#endif // CPPREADY_TRADER_GO_EXCHANGELIMITS_H
@@ -0,0 +1,57 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_EXECUTIONGATEWAY_H
+#define CPPREADY_TRADER_GO_EXECUTIONGATEWAY_H
+
+#include <cstdint>
+
+#include <ready_trader_go/types.h>
+
+// Everything the strategy needs from the outside world: somewhere to send
+// its orders and a clock. In a match this is the AutoTrader, which forwards
+// to the exchange; the replay engine provides its own so that recorded
+// market data can be run through the strategy deterministically.
+//
+// Orders leave as calls rather than as pre-encoded messages. The wire
+// encoding, the execution socket and its write buffer all belong to the
+// Ready Trader Go library, which exposes only these Send* calls, so there
+// is nowhere for a gateway to keep message templates and patch them. Nor
+// can it coalesce the messages one event sends: the socket is not exposed,
+// so there is nothing to cork or batch writes on.
+class ExecutionGateway {
+public:
+    virtual ~ExecutionGateway() = default;
+
+    virtual void SendAmendOrder(unsigned long clientOrderId,
+                                unsigned long volume) = 0;
+    virtual void SendCancelOrder(unsigned long clientOrderId) = 0;
+    virtual void SendHedgeOrder(unsigned long clientOrderId,
+                                ReadyTraderGo::Side side, unsigned long price,
+                                unsigned long volume) = 0;
+    virtual void SendInsertOrder(unsigned long clientOrderId,
+                                 ReadyTraderGo::Side side, unsigned long price,
+                                 unsigned long volume,
+                                 ReadyTraderGo::Lifespan lifespan) = 0;
+
+    // Monotonic time in nanoseconds. The strategies read it once as each
+    // event arrives and use that for everything the event sends, so a send
+    // costs no clock read of its own.
+    virtual std::uint64_t Now() const = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_EXECUTIONGATEWAY_H
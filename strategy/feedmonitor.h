@@ -0,0 +1,99 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_FEEDMONITOR_H
+#define CPPREADY_TRADER_GO_FEEDMONITOR_H
+
+#include <cstdint>
+
+#include <ready_trader_go/types.h>
+
+#include "bookrecord.h"
+#include "sequencetracker.h"
+
+// Watches the quality of the information feed: sequence numbers are
+// tracked separately for each instrument and message type, so a gap or a
+// reordered message on one stream never affects another, and an
+// instrument's book is considered stale once no update for it has arrived
+// for a while.
+class FeedMonitor {
+public:
+    explicit FeedMonitor(std::uint64_t staleAfter) : mStaleAfter(staleAfter) {}
+
+    // Records a message and returns true if it is newer than every earlier
+    // one of the same type for the instrument.
+    bool Update(RecordKind kind, ReadyTraderGo::Instrument instrument,
+                unsigned long sequenceNumber, std::uint64_t now) {
+        if (!Stream(kind, instrument).Update(sequenceNumber)) {
+            return false;
+        }
+        if (kind == RecordKind::ORDER_BOOK) {
+            mLastBook[Index(instrument)] = now;
+        }
+        return true;
+    }
+
+    // Whether the instrument's book has gone quiet. A book that has never
+    // been received is not stale, since nothing can have been quoted on
+    // it.
+    bool Stale(ReadyTraderGo::Instrument instrument, std::uint64_t now) const {
+        std::uint64_t last = mLastBook[Index(instrument)];
+        return last != 0 && now - last >= mStaleAfter;
+    }
+
+    const SequenceTracker &Stream(RecordKind kind,
+                                  ReadyTraderGo::Instrument instrument) const {
+        return mStreams[Index(kind)][Index(instrument)];
+    }
+
+    // Totals over every stream
+    unsigned long Missing() const {
+        return Sum(&SequenceTracker::Missing);
+    }
+    unsigned long Reordered() const {
+        return Sum(&SequenceTracker::Reordered);
+    }
+
+private:
+    static int Index(RecordKind kind) { return static_cast<int>(kind); }
+    static int Index(ReadyTraderGo::Instrument instrument) {
+        return static_cast<int>(instrument);
+    }
+
+    SequenceTracker &Stream(RecordKind kind,
+                            ReadyTraderGo::Instrument instrument) {
+        return mStreams[Index(kind)][Index(instrument)];
+    }
+
+    unsigned long Sum(unsigned long (SequenceTracker::*counter)() const) const {
+        unsigned long total = 0;
+        for (const auto &streams : mStreams) {
+            for (const SequenceTracker &stream : streams) {
+                total += (stream.*counter)();
+            }
+        }
+        return total;
+    }
+
+    std::uint64_t mStaleAfter;
+
+    // Indexed by message type, then instrument
+    SequenceTracker mStreams[2][2];
+    std::uint64_t mLastBook[2] = {};
+};
+
+#endif // CPPREADY_TRADER_GO_FEEDMONITOR_H
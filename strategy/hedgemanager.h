@@ -0,0 +1,141 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_HEDGEMANAGER_H
+#define CPPREADY_TRADER_GO_HEDGEMANAGER_H
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "ordertable.h"
+
+// The most hedge orders we wait on at once
+constexpr int MAX_OUTSTANDING_HEDGES = 4;
+
+// Aggregates the futures we need to trade to stay hedged into as few hedge
+// orders as possible, and reconciles them when they are filled.
+//
+// Exposure from ETF fills is held back for a short window after the first
+// unhedged fill, so that a sweep through several of our orders is hedged by
+// one order rather than one per fill, unless it reaches the threshold, in
+// which case it is due at once. Whatever a hedge order fails to fill is
+// added back and hedged again straight away. The window's end does not
+// wait for the next event: the adapter arms a timer for WindowEnd().
+//
+// A due hedge may still not go out: all MAX_OUTSTANDING_HEDGES may be
+// waiting on fills, or the rate governor may refuse it, and it is then
+// retried on the next event rather than by the timer. The manager cannot
+// stop more fills arriving, so the strategy stops quoting while Saturated()
+// and the unhedged volume stays near the threshold.
+//
+// Exposure is signed: positive means futures to buy.
+class HedgeManager {
+public:
+    HedgeManager(std::uint64_t window, unsigned long threshold)
+        : mWindow(window), mThreshold(threshold) {}
+
+    void AddExposure(long futures, std::uint64_t now) {
+        if (mUnhedged == 0) {
+            mWindowStart = now;
+        }
+        mUnhedged += futures;
+    }
+
+    // Makes whatever is unhedged due at once, for fills that should not
+    // wait for the window.
+    void Expedite() {
+        if (mUnhedged != 0) {
+            mRetry = true;
+        }
+    }
+
+    // Whether a hedge for Unhedged() should be sent now.
+    bool Due(std::uint64_t now) const {
+        if (mUnhedged == 0 || mOutstanding.Full()) {
+            return false;
+        }
+        return mRetry ||
+               static_cast<unsigned long>(std::labs(mUnhedged)) >=
+                   mThreshold ||
+               now - mWindowStart >= mWindow;
+    }
+
+    // When the window opened by the first unhedged fill closes, or zero if
+    // nothing is unhedged.
+    std::uint64_t WindowEnd() const {
+        return mUnhedged == 0 ? 0 : mWindowStart + mWindow;
+    }
+
+    // Records that a hedge order for all of Unhedged() has been sent.
+    void Sent(unsigned long clientOrderId) {
+        mOutstanding.Insert(clientOrderId, mUnhedged);
+        mOutstandingVolume += mUnhedged;
+        mUnhedged = 0;
+        mRetry = false;
+    }
+
+    // Reconciles a hedge order with its fill, setting filled to the signed
+    // volume traded. Returns false if the order is not one we are waiting
+    // on.
+    bool Filled(unsigned long clientOrderId, unsigned long volume,
+                std::uint64_t now, long &filled) {
+        long *order = mOutstanding.Find(clientOrderId);
+        if (order == nullptr) {
+            return false;
+        }
+        filled = *order > 0 ? static_cast<long>(volume)
+                              : -static_cast<long>(volume);
+        mPosition += filled;
+        mOutstandingVolume -= *order;
+        if (filled != *order) {
+            AddExposure(*order - filled, now);
+            mRetry = true;
+        }
+        mOutstanding.Erase(order);
+        return true;
+    }
+
+    // Exposure not yet covered by a hedge order
+    long Unhedged() const { return mUnhedged; }
+
+    // Whether the unhedged volume has reached the threshold. A hedge is due
+    // at once then, so if it is still unhedged after one was tried, none
+    // could be sent.
+    bool Saturated() const {
+        return static_cast<unsigned long>(std::labs(mUnhedged)) >= mThreshold;
+    }
+
+    // Volume of the hedge orders we are waiting on
+    long Outstanding() const { return mOutstandingVolume; }
+
+    // Our futures position, from filled hedges
+    long Position() const { return mPosition; }
+
+private:
+    std::uint64_t mWindow;
+    unsigned long mThreshold;
+
+    long mUnhedged = 0;
+    std::uint64_t mWindowStart = 0;
+    bool mRetry = false;
+
+    OrderTable<long, MAX_OUTSTANDING_HEDGES> mOutstanding;
+    long mOutstandingVolume = 0;
+    long mPosition = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_HEDGEMANAGER_H
@@ -0,0 +1,83 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <chrono>
+
+#include "hotlog.h"
+
+std::string HotLogFormatArgs(const char *format, const long *args,
+                             std::size_t argCount, std::uint8_t textMask) {
+    std::string result;
+    result.reserve(128);
+
+    std::size_t next = 0;
+    for (const char *c = format; *c != '\0'; c++) {
+        if (c[0] == '{' && c[1] == '}' && next < argCount) {
+            if (textMask & (1u << next)) {
+                result += reinterpret_cast<const char *>(args[next]);
+            } else {
+                result += std::to_string(args[next]);
+            }
+            next++;
+            c++;
+        } else {
+            result += *c;
+        }
+    }
+    return result;
+}
+
+HotLogRing &HotLogRing::Instance() {
+    static HotLogRing ring;
+    return ring;
+}
+
+HotLogRing::~HotLogRing() { Stop(); }
+
+void HotLogRing::Start() {
+    if (mRunning.exchange(true)) {
+        return;
+    }
+    mWriter = std::thread(&HotLogRing::WriterLoop, this);
+}
+
+void HotLogRing::Stop() {
+    mRunning.store(false, std::memory_order_release);
+    if (mWriter.joinable()) {
+        mWriter.join();
+    }
+    Drain();
+}
+
+void HotLogRing::Drain() {
+    auto tail = mTail.load(std::memory_order_relaxed);
+    auto head = mHead.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        const Record &record = mRecords[tail & (CAPACITY - 1)];
+        record.emit(record.level,
+                    HotLogFormatArgs(record.format, record.args,
+                                     record.argCount, record.textMask));
+    }
+    mTail.store(tail, std::memory_order_release);
+}
+
+void HotLogRing::WriterLoop() {
+    while (mRunning.load(std::memory_order_acquire)) {
+        Drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,212 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_HOTLOG_H
+#define CPPREADY_TRADER_GO_HOTLOG_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <ready_trader_go/logging.h>
+#include <ready_trader_go/types.h>
+
+// Log statements on the hot path (the information and execution callbacks)
+// use HOT_LOG instead of RLOG so that they can be compiled out:
+//
+//     HOT_LOG(LG_AT, LogLevel::LL_INFO, "order {} filled", clientOrderId);
+//
+// Each "{}" in the message is replaced by the next argument, and every
+// argument must be an integer, an enum or a string literal. Only a string's
+// pointer is kept, so it must outlive the statement; InstrumentName() gives
+// one for an instrument.
+//
+// RTG_HOT_LOG_LEVEL selects which statements are compiled in: 0 removes them
+// all, 1 keeps everything above LL_INFO and 2 keeps everything. It is set
+// from the CMake cache variable of the same name.
+//
+// With RTG_HOT_LOG_BINARY, statements that are kept only copy their
+// arguments into a lock-free ring; a background thread formats them and
+// passes them on to Boost.Log. Errors and disconnects should keep using RLOG.
+#define RTG_HOT_LOG_NONE 0
+#define RTG_HOT_LOG_ERROR 1
+#define RTG_HOT_LOG_INFO 2
+
+#ifndef RTG_HOT_LOG_LEVEL
+#define RTG_HOT_LOG_LEVEL RTG_HOT_LOG_INFO
+#endif
+
+constexpr int HotLogRank(ReadyTraderGo::LogLevel level) {
+    return level == ReadyTraderGo::LogLevel::LL_INFO ? RTG_HOT_LOG_INFO
+                                                     : RTG_HOT_LOG_ERROR;
+}
+
+constexpr bool HotLogEnabled(ReadyTraderGo::LogLevel level) {
+    return HotLogRank(level) <= RTG_HOT_LOG_LEVEL;
+}
+
+constexpr const char *InstrumentName(ReadyTraderGo::Instrument instrument) {
+    return instrument == ReadyTraderGo::Instrument::FUTURE ? "FUTURE" : "ETF";
+}
+
+// Hot log arguments are kept as longs; a string is kept as its pointer.
+template <typename T>
+constexpr bool HotLogIsText = std::is_convertible_v<T, const char *>;
+
+template <typename T> long HotLogValue(T value) {
+    if constexpr (HotLogIsText<T>) {
+        return reinterpret_cast<std::intptr_t>(
+            static_cast<const char *>(value));
+    } else {
+        return static_cast<long>(value);
+    }
+}
+
+// Bit i is set if argument i is a string.
+template <typename... Args> constexpr std::uint8_t HotLogTextMask() {
+    unsigned mask = 0;
+    unsigned bit = 1;
+    ((mask |= HotLogIsText<Args> ? bit : 0, bit <<= 1), ...);
+    return static_cast<std::uint8_t>(mask);
+}
+
+// Expands "{}" placeholders in format with the given arguments.
+std::string HotLogFormatArgs(const char *format, const long *args,
+                             std::size_t argCount, std::uint8_t textMask);
+
+template <typename... Args>
+std::string HotLogFormat(const char *format, Args... args) {
+    const long values[] = {0, HotLogValue(args)...};
+    return HotLogFormatArgs(format, values + 1, sizeof...(Args),
+                            HotLogTextMask<Args...>());
+}
+
+// Single-producer ring of unformatted log statements. Only the thread that
+// runs the autotrader's callbacks may call Push() while the ring is running.
+class HotLogRing {
+public:
+    static constexpr std::size_t MAX_ARGS = 6;
+    static constexpr std::size_t CAPACITY = 1 << 12;
+
+    using EmitFunction = void (*)(ReadyTraderGo::LogLevel level,
+                                  const std::string &message);
+
+    static HotLogRing &Instance();
+
+    // Starts the thread that formats and emits queued statements.
+    void Start();
+
+    // Emits everything still queued and stops the thread. Safe to call more
+    // than once.
+    void Stop();
+
+    template <typename... Args>
+    void Push(EmitFunction emit, ReadyTraderGo::LogLevel level,
+              const char *format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS,
+                      "too many arguments for a hot log statement");
+
+        // Nothing is queued unless the ring has been started, so tools that
+        // run several strategies on their own threads (the sweep) can leave
+        // it stopped.
+        if (!mRunning.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) == CAPACITY) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Record &record = mRecords[head & (CAPACITY - 1)];
+        record.emit = emit;
+        record.level = level;
+        record.format = format;
+        record.argCount = sizeof...(Args);
+        record.textMask = HotLogTextMask<Args...>();
+        const long values[] = {0, HotLogValue(args)...};
+        for (std::size_t i = 0; i < sizeof...(Args); i++) {
+            record.args[i] = values[i + 1];
+        }
+
+        mHead.store(head + 1, std::memory_order_release);
+    }
+
+    unsigned long DroppedCount() const {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Record {
+        EmitFunction emit;
+        const char *format;
+        ReadyTraderGo::LogLevel level;
+        std::uint8_t argCount;
+        std::uint8_t textMask;
+        long args[MAX_ARGS];
+    };
+
+    HotLogRing() = default;
+    ~HotLogRing();
+
+    void Drain();
+    void WriterLoop();
+
+    std::array<Record, CAPACITY> mRecords{};
+
+    alignas(64) std::atomic<std::uint64_t> mHead{0};
+    alignas(64) std::atomic<std::uint64_t> mTail{0};
+    alignas(64) std::atomic<unsigned long> mDropped{0};
+
+    std::atomic<bool> mRunning{false};
+    std::thread mWriter;
+};
+
+#if RTG_HOT_LOG_LEVEL == RTG_HOT_LOG_NONE
+// Nothing is evaluated, but the arguments are still name-checked.
+#define HOT_LOG(lg, lvl, ...)                                                  \
+    do {                                                                       \
+        if constexpr (false) {                                                 \
+            (void)HotLogFormat(__VA_ARGS__);                                   \
+        }                                                                      \
+    } while (0)
+#elif defined(RTG_HOT_LOG_BINARY)
+#define HOT_LOG(lg, lvl, ...)                                                  \
+    do {                                                                       \
+        if constexpr (HotLogEnabled(lvl)) {                                    \
+            HotLogRing::Instance().Push(                                       \
+                [](ReadyTraderGo::LogLevel level, const std::string &message) { \
+                    RLOG(lg, level) << message;                                \
+                },                                                             \
+                lvl, __VA_ARGS__);                                             \
+        }                                                                      \
+    } while (0)
+#else
+#define HOT_LOG(lg, lvl, ...)                                                  \
+    do {                                                                       \
+        if constexpr (HotLogEnabled(lvl)) {                                    \
+            RLOG(lg, lvl) << HotLogFormat(__VA_ARGS__);                        \
+        }                                                                      \
+    } while (0)
+#endif
+
+#endif // CPPREADY_TRADER_GO_HOTLOG_H
@@ -0,0 +1,56 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_IDLESTRATEGY_H
+#define CPPREADY_TRADER_GO_IDLESTRATEGY_H
+
+#include <array>
+#include <string>
+
+#include <ready_trader_go/types.h>
+
+#include "exchangelimits.h"
+#include "executiongateway.h"
+
+// Trades nothing, for an autotrader that only records the market.
+class IdleStrategy {
+public:
+    IdleStrategy(ExecutionGateway &, const ExchangeLimits &) {}
+
+    void DisconnectHandler() {}
+    void ErrorMessageHandler(unsigned long, const std::string &) {}
+    void HedgeFilledMessageHandler(unsigned long, unsigned long,
+                                   unsigned long) {}
+    void OrderBookMessageHandler(
+        ReadyTraderGo::Instrument, unsigned long,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &) {}
+    void OrderFilledMessageHandler(unsigned long, unsigned long,
+                                   unsigned long) {}
+    void OrderStatusMessageHandler(unsigned long, unsigned long,
+                                   unsigned long, signed long) {}
+    void TradeTicksMessageHandler(
+        ReadyTraderGo::Instrument, unsigned long,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT> &) {}
+};
+
+#endif // CPPREADY_TRADER_GO_IDLESTRATEGY_H
@@ -0,0 +1,61 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+
+#include "latencyprobes.h"
+
+static const char *const STAGE_NAMES[] = {"tick_to_decision", "tick_to_send",
+                                          "send_to_ack"};
+
+std::uint64_t LatencyHistogram::HighestValueIn(std::size_t bucket) {
+    if (bucket < SUB_BUCKET_COUNT) {
+        return bucket;
+    }
+    std::size_t shift = bucket / SUB_BUCKET_COUNT - 1;
+    std::uint64_t lowest = (SUB_BUCKET_COUNT + bucket % SUB_BUCKET_COUNT)
+                           << shift;
+    return lowest + (std::uint64_t{1} << shift) - 1;
+}
+
+std::uint64_t LatencyHistogram::Percentile(double fraction) const {
+    if (mCount == 0) {
+        return 0;
+    }
+    auto target = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(fraction * mCount)));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        seen += mCounts[bucket];
+        if (seen >= target) {
+            return std::min(HighestValueIn(bucket), mMax);
+        }
+    }
+    return mMax;
+}
+
+void LatencyProbes::Report(std::ostream &out) const {
+    for (std::size_t i = 0; i < mHistograms.size(); i++) {
+        const LatencyHistogram &histogram = mHistograms[i];
+        out << STAGE_NAMES[i] << ": count " << histogram.Count() << " p50 "
+            << histogram.Percentile(0.5) << " p99 "
+            << histogram.Percentile(0.99) << " p99.9 "
+            << histogram.Percentile(0.999) << " max " << histogram.Max()
+            << " ns\n";
+    }
+}
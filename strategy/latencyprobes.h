@@ -0,0 +1,196 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LATENCYPROBES_H
+#define CPPREADY_TRADER_GO_LATENCYPROBES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "monotonicclock.h"
+
+// A histogram of nanosecond durations with a fixed relative precision, in
+// the style of HdrHistogram: values below 32 have a bucket each, and every
+// power-of-two range above that is split into 32 equal buckets, so any
+// recorded value is known to within about 3%. Recording is a bit scan and
+// an increment; nothing is allocated.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr std::uint64_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static constexpr std::size_t BUCKET_COUNT =
+        (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    void Record(std::uint64_t value) {
+        mCounts[BucketFor(value)]++;
+        mCount++;
+        if (value > mMax) {
+            mMax = value;
+        }
+    }
+
+    std::uint64_t Count() const { return mCount; }
+    std::uint64_t Max() const { return mMax; }
+
+    // The smallest value that at least the given fraction of the samples
+    // is no greater than, rounded up to the end of its bucket.
+    std::uint64_t Percentile(double fraction) const;
+
+    void Reset() { *this = LatencyHistogram(); }
+
+private:
+    static std::size_t BucketFor(std::uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) {
+            return value;
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        int shift = exponent - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKET_COUNT +
+               ((value >> shift) - SUB_BUCKET_COUNT);
+    }
+
+    static std::uint64_t HighestValueIn(std::size_t bucket);
+
+    std::array<std::uint32_t, BUCKET_COUNT> mCounts{};
+    std::uint64_t mCount = 0;
+    std::uint64_t mMax = 0;
+};
+
+enum class LatencyStage : unsigned char {
+    // Order book handler entry to the repricing decision being made
+    TICK_TO_DECISION,
+    // Order book handler entry to each send returning
+    TICK_TO_SEND,
+    // A send returning to the first order status (or hedge fill) for it
+    SEND_TO_ACK,
+    COUNT
+};
+
+// Probes for the stages between a book update arriving and our orders
+// being acknowledged. Compiled to nothing unless RTG_LATENCY_PROBES is
+// defined (see the CMake option of the same name).
+//
+// The exchange's publish time is not available to us, so ticks are timed
+// from handler entry. The probes keep their own clock rather than asking
+// the execution gateway, whose clock stands still during a replay. It is
+// calibrated when the first probes are constructed, so no tick pays for
+// that.
+class LatencyProbes {
+public:
+    // Snapshots are taken at most this often, in nanoseconds.
+    static constexpr std::uint64_t SNAPSHOT_INTERVAL = 60'000'000'000;
+
+    void BeginTick() {
+#ifdef RTG_LATENCY_PROBES
+        mTickStart = mClock->Now();
+#endif
+    }
+
+    void Decided() {
+#ifdef RTG_LATENCY_PROBES
+        if (mTickStart != 0) {
+            Record(LatencyStage::TICK_TO_DECISION, mClock->Now() - mTickStart);
+        }
+#endif
+    }
+
+    void Sent(unsigned long clientOrderId) {
+#ifdef RTG_LATENCY_PROBES
+        auto now = mClock->Now();
+        if (mTickStart != 0) {
+            Record(LatencyStage::TICK_TO_SEND, now - mTickStart);
+        }
+        mInFlight[clientOrderId & (IN_FLIGHT_SLOTS - 1)] = {clientOrderId, now};
+#endif
+    }
+
+    void Acknowledged(unsigned long clientOrderId) {
+#ifdef RTG_LATENCY_PROBES
+        InFlight &slot = mInFlight[clientOrderId & (IN_FLIGHT_SLOTS - 1)];
+        if (slot.clientOrderId == clientOrderId) {
+            Record(LatencyStage::SEND_TO_ACK, mClock->Now() - slot.sentAt);
+            slot.clientOrderId = 0;
+        }
+#endif
+    }
+
+    // Ends the current tick. Returns true when a periodic snapshot is due.
+    bool EndTick() {
+#ifdef RTG_LATENCY_PROBES
+        mTickStart = 0;
+        auto now = mClock->Now();
+        if (mLastSnapshot == 0) {
+            mLastSnapshot = now;
+        } else if (now - mLastSnapshot >= SNAPSHOT_INTERVAL) {
+            mLastSnapshot = now;
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    const LatencyHistogram &Histogram(LatencyStage stage) const {
+        return mHistograms[static_cast<std::size_t>(stage)];
+    }
+
+    // The duration most recently recorded for a stage, or zero
+    std::uint64_t Last(LatencyStage stage) const {
+        return mLast[static_cast<std::size_t>(stage)];
+    }
+
+    // Writes one line per stage with the sample count, p50, p99, p99.9 and
+    // maximum in nanoseconds.
+    void Report(std::ostream &out) const;
+
+private:
+    // Orders still waiting for an acknowledgement, by client order id. An
+    // order whose slot is reused before it is acknowledged goes unmeasured.
+    static constexpr std::size_t IN_FLIGHT_SLOTS = 64;
+
+    struct InFlight {
+        unsigned long clientOrderId;
+        std::uint64_t sentAt;
+    };
+
+    // Shared by every strategy in the process, since calibrating the TSC
+    // takes a while.
+    static const MonotonicClock &Clock() {
+        static const MonotonicClock clock;
+        return clock;
+    }
+
+    void Record(LatencyStage stage, std::uint64_t duration) {
+        mHistograms[static_cast<std::size_t>(stage)].Record(duration);
+        mLast[static_cast<std::size_t>(stage)] = duration;
+    }
+
+    std::array<LatencyHistogram, static_cast<std::size_t>(LatencyStage::COUNT)>
+        mHistograms{};
+    std::array<std::uint64_t, static_cast<std::size_t>(LatencyStage::COUNT)>
+        mLast{};
+    std::array<InFlight, IN_FLIGHT_SLOTS> mInFlight{};
+    std::uint64_t mTickStart = 0;
+    std::uint64_t mLastSnapshot = 0;
+
+#ifdef RTG_LATENCY_PROBES
+    const MonotonicClock *mClock = &Clock();
+#endif
+};
+
+#endif // CPPREADY_TRADER_GO_LATENCYPROBES_H
@@ -0,0 +1,161 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "livemetrics.h"
+
+namespace {
+
+struct MetricInfo {
+    const char *name;
+    const char *type;
+    const char *help;
+};
+
+// In the order of Metric
+constexpr MetricInfo METRICS[] = {
+    {"rtg_etf_position", "gauge", "ETF position in lots"},
+    {"rtg_future_position", "gauge", "Future position in lots"},
+    {"rtg_etf_buy_exposure", "gauge",
+     "Lots our resting bids would add to the ETF position"},
+    {"rtg_etf_sell_exposure", "gauge",
+     "Lots our resting asks would take from the ETF position"},
+    {"rtg_ask_orders", "gauge", "Asks in the market"},
+    {"rtg_bid_orders", "gauge", "Bids in the market"},
+    {"rtg_unhedged_volume", "gauge", "ETF lots not yet hedged"},
+    {"rtg_message_budget", "gauge",
+     "Messages the rate governor would allow now"},
+    {"rtg_messages_throttled_total", "counter",
+     "Messages the rate governor has held back"},
+    {"rtg_feed_missing_total", "counter",
+     "Information messages missed, from sequence gaps"},
+    {"rtg_feed_reordered_total", "counter",
+     "Information messages received out of order"},
+    {"rtg_profit_or_loss_cents", "gauge",
+     "Profit or loss, marked to the latest mid prices"},
+    {"rtg_fees_cents", "gauge", "Net fees paid"},
+    {"rtg_tick_to_decision_nanoseconds", "gauge",
+     "Order book handler entry to the repricing decision, latest tick"},
+    {"rtg_tick_to_send_nanoseconds", "gauge",
+     "Order book handler entry to a send returning, latest send"},
+    {"rtg_send_to_ack_nanoseconds", "gauge",
+     "A send returning to its acknowledgement, latest acknowledgement"},
+};
+
+static_assert(std::size(METRICS) == static_cast<std::size_t>(Metric::COUNT),
+              "every metric needs a name");
+
+} // namespace
+
+void LiveMetrics::WritePrometheus(std::ostream &out) const {
+    for (std::size_t i = 0; i < std::size(METRICS); i++) {
+        const MetricInfo &info = METRICS[i];
+        out << "# HELP " << info.name << ' ' << info.help << '\n'
+            << "# TYPE " << info.name << ' ' << info.type << '\n'
+            << info.name << ' ' << Get(static_cast<Metric>(i)) << '\n';
+    }
+}
+
+MetricsOptions LoadMetricsOptions(const std::string &filename) {
+    MetricsOptions options;
+
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::read_json(filename, tree);
+    } catch (const boost::property_tree::json_parser_error &) {
+        return options;
+    }
+
+    options.file = tree.get("Metrics.File", options.file);
+    // Clamped before the conversion, since a negative interval has no
+    // unsigned value
+    double interval = tree.get("Metrics.Interval", options.interval / 1e9);
+    options.interval = static_cast<std::uint64_t>(
+        std::max(MIN_METRICS_INTERVAL / 1e9, interval) * 1e9);
+
+    return options;
+}
+
+MetricsExporter::~MetricsExporter() { Stop(); }
+
+void MetricsExporter::Start(const LiveMetrics &metrics,
+                            const MetricsOptions &options) {
+    if (options.file.empty() || mWriter.joinable()) {
+        return;
+    }
+    mMetrics = &metrics;
+    mOptions = options;
+    // Anything shorter and the writer thread would spin
+    mOptions.interval = std::max(mOptions.interval, MIN_METRICS_INTERVAL);
+    mRunning = true;
+    mWriter = std::thread(&MetricsExporter::WriterLoop, this);
+}
+
+void MetricsExporter::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning = false;
+    }
+    mWake.notify_all();
+    if (mWriter.joinable()) {
+        mWriter.join();
+    }
+}
+
+void MetricsExporter::WriterLoop() {
+#ifdef __linux__
+    sched_param parameters{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameters);
+#endif
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mRunning) {
+        lock.unlock();
+        Write();
+        lock.lock();
+        mWake.wait_for(lock, std::chrono::nanoseconds(mOptions.interval),
+                       [this] { return !mRunning; });
+    }
+    lock.unlock();
+    Write();
+}
+
+void MetricsExporter::Write() const {
+    // Readers only ever see a whole file
+    std::string temporary = mOptions.file + ".tmp";
+    std::ofstream out(temporary, std::ios::trunc);
+    mMetrics->WritePrometheus(out);
+    // Most of the file is only written as it is closed, and a truncated
+    // file must never replace the last good one
+    out.close();
+    if (!out) {
+        return;
+    }
+    std::rename(temporary.c_str(), mOptions.file.c_str());
+}
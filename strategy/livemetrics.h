@@ -0,0 +1,132 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIVEMETRICS_H
+#define CPPREADY_TRADER_GO_LIVEMETRICS_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+enum class Metric : unsigned char {
+    ETF_POSITION,
+    FUTURE_POSITION,
+    ETF_BUY_EXPOSURE,
+    ETF_SELL_EXPOSURE,
+    ASK_ORDERS,
+    BID_ORDERS,
+    UNHEDGED_VOLUME,
+    MESSAGE_BUDGET,
+    MESSAGES_THROTTLED,
+    FEED_MISSING,
+    FEED_REORDERED,
+    PROFIT_OR_LOSS,
+    FEES,
+    TICK_TO_DECISION,
+    TICK_TO_SEND,
+    SEND_TO_ACK,
+    COUNT
+};
+
+// The strategy's state as of the last event it handled, for monitoring
+// while it trades. The strategy thread stores each value with a relaxed
+// atomic store, which costs no more than a plain one, and any other thread
+// may read them at any time. Values are not updated together, so a reader
+// may see one that is an event newer than another.
+//
+// The values fill whole cache lines of their own, so nothing else the
+// strategy writes shares a line with what a reader reads.
+class alignas(64) LiveMetrics {
+public:
+    void Set(Metric metric, std::int64_t value) {
+        mValues[static_cast<std::size_t>(metric)].store(
+            value, std::memory_order_relaxed);
+    }
+
+    std::int64_t Get(Metric metric) const {
+        return mValues[static_cast<std::size_t>(metric)].load(
+            std::memory_order_relaxed);
+    }
+
+    // Writes every metric in the Prometheus text exposition format.
+    void WritePrometheus(std::ostream &out) const;
+
+private:
+    std::array<std::atomic<std::int64_t>,
+               static_cast<std::size_t>(Metric::COUNT)>
+        mValues{};
+};
+
+// The optional "Metrics" block of autotrader.json:
+//
+//     "Metrics": {
+//       "File": "metrics.prom",
+//       "Interval": 1.0
+//     }
+//
+// If a file is named, the metrics are written to it every Interval
+// seconds, replacing what was there, in a form Prometheus (through the node
+// exporter's textfile collector) or anything else can read. Intervals
+// shorter than MIN_METRICS_INTERVAL are raised to it.
+constexpr std::uint64_t MIN_METRICS_INTERVAL = 100'000'000; // nanoseconds
+
+struct MetricsOptions {
+    std::string file;
+    std::uint64_t interval = 1'000'000'000;
+};
+
+MetricsOptions LoadMetricsOptions(const std::string &filename);
+
+// Writes a strategy's metrics to a file from a thread of its own, which
+// runs at the lowest priority the system has so it never competes with
+// the event loop.
+class MetricsExporter {
+public:
+    MetricsExporter() = default;
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    // Does nothing if no file is named. The metrics must outlive the
+    // exporter, or the call to Stop().
+    void Start(const LiveMetrics &metrics, const MetricsOptions &options);
+
+    // Writes the metrics one last time and stops the thread. Safe to call
+    // more than once.
+    void Stop();
+
+private:
+    void WriterLoop();
+    void Write() const;
+
+    const LiveMetrics *mMetrics = nullptr;
+    MetricsOptions mOptions;
+
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    bool mRunning = false;
+    std::thread mWriter;
+};
+
+#endif // CPPREADY_TRADER_GO_LIVEMETRICS_H
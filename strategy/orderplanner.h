@@ -0,0 +1,165 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_ORDERPLANNER_H
+#define CPPREADY_TRADER_GO_ORDERPLANNER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include <ready_trader_go/types.h>
+
+enum class OrderActionType : unsigned char { CANCEL, AMEND, INSERT };
+
+// Actions are sent in this order. Cancelling an order that is priced through
+// our new quote matters most, since it can be filled at a price we no
+// longer want. Cancelling our worst-priced order to make room comes next,
+// so that the insert taking its place never rests alongside it, even
+// briefly.
+enum class OrderActionUrgency : unsigned char {
+    STALE_CANCEL,
+    EVICTION_CANCEL,
+    INSERT,
+    AMEND
+};
+
+struct OrderAction {
+    OrderActionType type;
+    OrderActionUrgency urgency;
+    ReadyTraderGo::Side side;
+    // Zero for inserts, which are given an id when they are sent.
+    unsigned long clientOrderId;
+    unsigned long price;
+    // The order's remaining volume for cancels, the new remaining volume for
+    // amends and the order volume for inserts.
+    unsigned long volume;
+    // How far the order is from the price we want to quote, in cents.
+    unsigned long distance;
+};
+
+// Collects the cancels, amends and inserts wanted on both sides of the book
+// while handling one event, then sends the smallest equivalent batch, most
+// urgent first.
+//
+// Before anything is sent, a cancel and an insert at the same price on the
+// same side are netted against each other: the resting order is kept (and
+// amended down if the insert was for less volume) instead of being pulled
+// and re-entered at the back of the queue.
+template <std::size_t Capacity> class OrderPlanner {
+public:
+    void Cancel(ReadyTraderGo::Side side, unsigned long clientOrderId,
+                unsigned long price, unsigned long remainingVolume,
+                unsigned long distance, OrderActionUrgency urgency) {
+        Add({OrderActionType::CANCEL, urgency, side, clientOrderId, price,
+             remainingVolume, distance});
+    }
+
+    void Amend(ReadyTraderGo::Side side, unsigned long clientOrderId,
+               unsigned long price, unsigned long newVolume) {
+        Add({OrderActionType::AMEND, OrderActionUrgency::AMEND, side,
+             clientOrderId, price, newVolume, 0});
+    }
+
+    void Insert(ReadyTraderGo::Side side, unsigned long price,
+                unsigned long volume) {
+        if (volume == 0) {
+            return;
+        }
+        Add({OrderActionType::INSERT, OrderActionUrgency::INSERT, side, 0,
+             price, volume, 0});
+    }
+
+    // Nets and orders the planned actions, passes each one to
+    // sink.ExecuteOrderAction() and clears the plan. Returns the number of
+    // actions executed.
+    template <typename Sink> std::size_t Emit(Sink &sink) {
+        Net();
+        std::sort(mActions.begin(), mActions.begin() + mSize,
+                  [](const OrderAction &a, const OrderAction &b) {
+                      if (a.urgency != b.urgency) {
+                          return a.urgency < b.urgency;
+                      }
+                      return a.distance > b.distance;
+                  });
+
+        std::size_t count = mSize;
+        for (std::size_t i = 0; i < count; i++) {
+            sink.ExecuteOrderAction(mActions[i]);
+        }
+        mSize = 0;
+        return count;
+    }
+
+    void Clear() { mSize = 0; }
+    std::size_t Size() const { return mSize; }
+    bool Empty() const { return mSize == 0; }
+
+private:
+    void Add(const OrderAction &action) {
+        if (mSize < Capacity) {
+            mActions[mSize++] = action;
+        }
+    }
+
+    void Remove(std::size_t index) { mActions[index] = mActions[--mSize]; }
+
+    void Net() {
+        std::size_t i = 0;
+        while (i < mSize) {
+            // Netting moves actions around, so start again when it happens.
+            if (mActions[i].type == OrderActionType::INSERT && NetInsert(i)) {
+                i = 0;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    bool NetInsert(std::size_t i) {
+        for (std::size_t j = 0; j < mSize; j++) {
+            OrderAction &cancel = mActions[j];
+            OrderAction &insert = mActions[i];
+            if (cancel.type != OrderActionType::CANCEL ||
+                cancel.side != insert.side || cancel.price != insert.price) {
+                continue;
+            }
+
+            if (insert.volume < cancel.volume) {
+                // Keep the resting order, with less volume.
+                cancel.type = OrderActionType::AMEND;
+                cancel.urgency = OrderActionUrgency::AMEND;
+                cancel.volume = insert.volume;
+                Remove(i);
+            } else if (insert.volume == cancel.volume) {
+                Remove(std::max(i, j));
+                Remove(std::min(i, j));
+            } else {
+                // Keep the resting order and only add the difference.
+                insert.volume -= cancel.volume;
+                Remove(j);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    std::array<OrderAction, Capacity> mActions{};
+    std::size_t mSize = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_ORDERPLANNER_H
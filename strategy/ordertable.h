@@ -0,0 +1,103 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_ORDERTABLE_H
+#define CPPREADY_TRADER_GO_ORDERTABLE_H
+
+#include <array>
+#include <cstddef>
+
+// A fixed-capacity table of the orders we have resting on one side of the
+// book, keyed by client order id.
+//
+// We never hold more than a handful of orders, so entries are kept densely
+// packed in a single array: lookup is a short linear scan, iteration touches
+// only the live entries and nothing is allocated after construction. Erasing
+// moves the last entry into the freed slot, so pointers returned by Find()
+// and Insert() are only valid until the next Erase().
+template <typename T, std::size_t Capacity> class OrderTable {
+public:
+    struct Entry {
+        unsigned long id;
+        T order;
+    };
+
+    using iterator = Entry *;
+    using const_iterator = const Entry *;
+
+    // Returns the order with the given id, or nullptr if it is not tracked.
+    T *Find(unsigned long id) {
+        for (std::size_t i = 0; i < mSize; i++) {
+            if (mEntries[i].id == id) {
+                return &mEntries[i].order;
+            }
+        }
+        return nullptr;
+    }
+
+    const T *Find(unsigned long id) const {
+        return const_cast<OrderTable *>(this)->Find(id);
+    }
+
+    bool Contains(unsigned long id) const { return Find(id) != nullptr; }
+
+    // Adds an order and returns it, or returns nullptr if the table is full.
+    T *Insert(unsigned long id, const T &order) {
+        if (mSize == Capacity) {
+            return nullptr;
+        }
+        mEntries[mSize] = {id, order};
+        return &mEntries[mSize++].order;
+    }
+
+    // Removes an order previously returned by Find() or Insert().
+    void Erase(T *order) {
+        for (std::size_t i = 0; i < mSize; i++) {
+            if (&mEntries[i].order == order) {
+                mEntries[i] = mEntries[--mSize];
+                return;
+            }
+        }
+    }
+
+    bool Erase(unsigned long id) {
+        T *order = Find(id);
+        if (order == nullptr) {
+            return false;
+        }
+        Erase(order);
+        return true;
+    }
+
+    void Clear() { mSize = 0; }
+
+    std::size_t Size() const { return mSize; }
+    bool Empty() const { return mSize == 0; }
+    bool Full() const { return mSize == Capacity; }
+    static constexpr std::size_t MaxSize() { return Capacity; }
+
+    iterator begin() { return mEntries.data(); }
+    iterator end() { return mEntries.data() + mSize; }
+    const_iterator begin() const { return mEntries.data(); }
+    const_iterator end() const { return mEntries.data() + mSize; }
+
+private:
+    std::array<Entry, Capacity> mEntries{};
+    std::size_t mSize = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_ORDERTABLE_H
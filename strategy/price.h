@@ -0,0 +1,76 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_PRICE_H
+#define CPPREADY_TRADER_GO_PRICE_H
+
+#include <algorithm>
+
+#include "tradingconstants.h"
+
+// Integer price arithmetic, in cents. Prices the exchange accepts are whole
+// multiples of TICK_SIZE_IN_CENTS between MIN_BID_NEAREST_TICK and
+// MAX_ASK_NEAREST_TICK.
+//
+// Everything here is branch-free, and every division is by a compile-time
+// constant, which the compiler turns into a multiply by its reciprocal and
+// a shift.
+
+constexpr unsigned long BASIS_POINTS = 10000;
+
+// The furthest a price can be moved down, in basis points, without going to
+// zero or below
+constexpr long MIN_BASIS = 1 - static_cast<long>(BASIS_POINTS);
+
+constexpr unsigned long RoundDownToTick(unsigned long price) {
+    return price / TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
+}
+
+constexpr unsigned long RoundUpToTick(unsigned long price) {
+    return (price + TICK_SIZE_IN_CENTS - 1) / TICK_SIZE_IN_CENTS *
+           TICK_SIZE_IN_CENTS;
+}
+
+// Limits a price on the tick grid to the range the exchange accepts.
+constexpr unsigned long ClampToTickRange(unsigned long price) {
+    return std::clamp(price, (unsigned long)MIN_BID_NEAREST_TICK,
+                      (unsigned long)MAX_ASK_NEAREST_TICK);
+}
+
+// Moves a price by the given number of basis points onto the tick grid,
+// rounding up (for asks) or down (for bids) so the quote is never tighter
+// than asked for. The basis must be at least MIN_BASIS.
+//
+// Scaling by basis points and ticks in one step keeps this to a multiply
+// and a single constant division, with no intermediate rounding.
+constexpr unsigned long MultiplyBasis(unsigned long price, long basis,
+                                      bool ceil) {
+    constexpr unsigned long SCALE = BASIS_POINTS * TICK_SIZE_IN_CENTS;
+    unsigned long scaled = price * (BASIS_POINTS + basis);
+    unsigned long ticks = (scaled + ceil * (SCALE - 1)) / SCALE;
+    return ClampToTickRange(ticks * TICK_SIZE_IN_CENTS);
+}
+
+static_assert(RoundDownToTick(10099) == 10000);
+static_assert(RoundUpToTick(10001) == 10100);
+static_assert(RoundUpToTick(10000) == 10000);
+static_assert(MultiplyBasis(100000, 7, true) == 100100);
+static_assert(MultiplyBasis(100000, -7, false) == 99900);
+static_assert(MultiplyBasis(100000, 0, true) == 100000);
+static_assert(MultiplyBasis(50, -7, false) == MIN_BID_NEAREST_TICK);
+
+#endif // CPPREADY_TRADER_GO_PRICE_H
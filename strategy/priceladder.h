@@ -0,0 +1,151 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_PRICELADDER_H
+#define CPPREADY_TRADER_GO_PRICELADDER_H
+
+#include <array>
+#include <cstddef>
+
+#include <ready_trader_go/types.h>
+
+// The orders we have resting on one side of the book, kept sorted from the
+// best price to the worst (lowest first for asks, highest first for bids),
+// with the same interface as OrderTable plus a way to find where a price
+// sits in it.
+//
+// Repricing a side then needs no search: the orders priced through a new
+// quote are a prefix of the ladder, the orders at it come next and the
+// order furthest from it is last. Entries are kept densely packed in a
+// single array and nothing is allocated after construction. Inserting and
+// erasing shift the entries behind them, so pointers returned by Find()
+// and Insert() are only valid until the next Insert() or Erase().
+//
+// T must have a price member, which must not change while it is in the
+// ladder.
+template <typename T, std::size_t Capacity> class PriceLadder {
+public:
+    struct Entry {
+        unsigned long id;
+        T order;
+    };
+
+    using iterator = Entry *;
+    using const_iterator = const Entry *;
+
+    explicit PriceLadder(ReadyTraderGo::Side side)
+        : mAscending(side == ReadyTraderGo::Side::SELL) {}
+
+    // Returns the order with the given id, or nullptr if it is not tracked.
+    T *Find(unsigned long id) {
+        for (std::size_t i = 0; i < mSize; i++) {
+            if (mEntries[i].id == id) {
+                return &mEntries[i].order;
+            }
+        }
+        return nullptr;
+    }
+
+    const T *Find(unsigned long id) const {
+        return const_cast<PriceLadder *>(this)->Find(id);
+    }
+
+    bool Contains(unsigned long id) const { return Find(id) != nullptr; }
+
+    // Adds an order behind any others at the same price and returns it, or
+    // returns nullptr if the ladder is full.
+    T *Insert(unsigned long id, const T &order) {
+        if (mSize == Capacity) {
+            return nullptr;
+        }
+        std::size_t slot = LevelEnd(order.price);
+        for (std::size_t i = mSize; i > slot; i--) {
+            mEntries[i] = mEntries[i - 1];
+        }
+        mEntries[slot] = {id, order};
+        mSize++;
+        return &mEntries[slot].order;
+    }
+
+    // Removes an order previously returned by Find() or Insert().
+    void Erase(T *order) {
+        for (std::size_t i = 0; i < mSize; i++) {
+            if (&mEntries[i].order == order) {
+                for (mSize--; i < mSize; i++) {
+                    mEntries[i] = mEntries[i + 1];
+                }
+                return;
+            }
+        }
+    }
+
+    bool Erase(unsigned long id) {
+        T *order = Find(id);
+        if (order == nullptr) {
+            return false;
+        }
+        Erase(order);
+        return true;
+    }
+
+    // The index of the first order not priced better than the given price;
+    // every order before it is priced better.
+    std::size_t LevelBegin(unsigned long price) const {
+        std::size_t i = 0;
+        while (i < mSize && Better(mEntries[i].order.price, price)) {
+            i++;
+        }
+        return i;
+    }
+
+    // The index of the first order priced worse than the given price.
+    std::size_t LevelEnd(unsigned long price) const {
+        std::size_t i = mSize;
+        while (i > 0 && Better(price, mEntries[i - 1].order.price)) {
+            i--;
+        }
+        return i;
+    }
+
+    Entry &operator[](std::size_t index) { return mEntries[index]; }
+    const Entry &operator[](std::size_t index) const {
+        return mEntries[index];
+    }
+
+    void Clear() { mSize = 0; }
+
+    std::size_t Size() const { return mSize; }
+    bool Empty() const { return mSize == 0; }
+    bool Full() const { return mSize == Capacity; }
+    static constexpr std::size_t MaxSize() { return Capacity; }
+
+    iterator begin() { return mEntries.data(); }
+    iterator end() { return mEntries.data() + mSize; }
+    const_iterator begin() const { return mEntries.data(); }
+    const_iterator end() const { return mEntries.data() + mSize; }
+
+private:
+    bool Better(unsigned long a, unsigned long b) const {
+        return mAscending ? a < b : a > b;
+    }
+
+    bool mAscending;
+    std::array<Entry, Capacity> mEntries{};
+    std::size_t mSize = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_PRICELADDER_H
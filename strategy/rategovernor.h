@@ -0,0 +1,94 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_RATEGOVERNOR_H
+#define CPPREADY_TRADER_GO_RATEGOVERNOR_H
+
+#include <cstdint>
+#include <vector>
+
+// Critical messages (hedges and cancels of orders priced through our quote)
+// may use the whole budget; normal ones must leave the reserve untouched.
+enum class MessagePriority : unsigned char { NORMAL, CRITICAL };
+
+// Keeps the messages we send within the exchange's message frequency limit.
+//
+// The send times of the messages still inside the window are kept in a ring
+// sized to the limit, so checking and recording a send is O(1) (amortized
+// over the sends that expire) and nothing is allocated after construction.
+class RateGovernor {
+public:
+    // The safety margin is taken off the exchange's limit to allow for the
+    // difference between our clock and the exchange's; the reserve is then
+    // kept back for critical messages.
+    RateGovernor(unsigned long limit, std::uint64_t interval,
+                 unsigned long safetyMargin, unsigned long reserve)
+        : mCapacity(limit > safetyMargin ? limit - safetyMargin : 1),
+          mReserve(reserve < mCapacity ? reserve : mCapacity - 1),
+          mInterval(interval), mSendTimes(mCapacity) {}
+
+    // Messages of the given priority that could be sent right now.
+    unsigned long Remaining(std::uint64_t now,
+                            MessagePriority priority = MessagePriority::NORMAL) {
+        Expire(now);
+        unsigned long allowed = Allowed(priority);
+        return mUsed < allowed ? allowed - mUsed : 0;
+    }
+
+    // Records a send and returns true if the message fits in the budget,
+    // otherwise counts it as throttled and returns false.
+    bool TryAcquire(std::uint64_t now,
+                    MessagePriority priority = MessagePriority::NORMAL) {
+        Expire(now);
+        if (mUsed >= Allowed(priority)) {
+            mThrottled++;
+            return false;
+        }
+        mSendTimes[mHead] = now;
+        mHead = mHead + 1 == mCapacity ? 0 : mHead + 1;
+        mUsed++;
+        return true;
+    }
+
+    unsigned long Capacity() const { return mCapacity; }
+    unsigned long ThrottledCount() const { return mThrottled; }
+
+private:
+    unsigned long Allowed(MessagePriority priority) const {
+        return priority == MessagePriority::CRITICAL ? mCapacity
+                                                     : mCapacity - mReserve;
+    }
+
+    void Expire(std::uint64_t now) {
+        while (mUsed != 0 && mSendTimes[mTail] + mInterval <= now) {
+            mTail = mTail + 1 == mCapacity ? 0 : mTail + 1;
+            mUsed--;
+        }
+    }
+
+    unsigned long mCapacity;
+    unsigned long mReserve;
+    std::uint64_t mInterval;
+
+    std::vector<std::uint64_t> mSendTimes;
+    unsigned long mHead = 0;
+    unsigned long mTail = 0;
+    unsigned long mUsed = 0;
+    unsigned long mThrottled = 0;
+};
+
+#endif // CPPREADY_TRADER_GO_RATEGOVERNOR_H
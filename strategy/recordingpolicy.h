@@ -0,0 +1,60 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_RECORDINGPOLICY_H
+#define CPPREADY_TRADER_GO_RECORDINGPOLICY_H
+
+#include <array>
+#include <cstdint>
+
+#include <ready_trader_go/types.h>
+
+#include "bookrecord.h"
+#include "monotonicclock.h"
+#include "recorder.h"
+
+// What an autotrader does with the market data it receives, besides
+// trading on it. See BasicAutoTrader in autotrader.h.
+
+// Records nothing; every call compiles away.
+struct NoRecording {
+    explicit NoRecording(const MonotonicClock &) {}
+
+    void Record(RecordKind, ReadyTraderGo::Instrument, unsigned long,
+                std::uint64_t,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &,
+                const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+                    &) {}
+
+    void Close() {}
+    unsigned long DroppedCount() const { return 0; }
+    unsigned long UnwrittenCount() const { return 0; }
+};
+
+// Records every order book and trade ticks message to market_data.bin, in
+// the format the replay tool reads.
+struct BookRecording : BookRecorder {
+    explicit BookRecording(const MonotonicClock &clock)
+        : BookRecorder("market_data.bin", clock) {}
+};
+
+#endif // CPPREADY_TRADER_GO_RECORDINGPOLICY_H
@@ -0,0 +1,155 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+// Runs a recording made by agg/ through the strategy against a simulated
+// exchange (see ReplayExchange) and reports how it did. The same recording
+// always gives the same result, so the summary can be compared between
+// commits.
+//
+// Usage: replay [-v] [-p SAMPLES_CSV] [-c AUTOTRADER_JSON] [-w FROM:TO]
+//               [RECORDING [EXCHANGE_JSON]]
+//
+// The strategy's own log output is suppressed unless -v is given. With -p,
+// the strategy's once-a-second accounting samples are written to the given
+// CSV file. With -c, the strategy sizes its orders with the "Sizing" block
+// of the given autotrader configuration, and takes the ETF as its
+// "Arbitrage" block says. With -w, only the part of the
+// recording from FROM to TO seconds after it started is replayed; the
+// recording may also be a book store made by agg/'s record2store, in which
+// case only that part is read.
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/log/core.hpp>
+
+#include <ready_trader_go/error.h>
+
+#include "exchangelimits.h"
+#include "hotlog.h"
+#include "replayexchange.h"
+#include "strategy.h"
+
+int main(int argc, char *argv[]) {
+    bool verbose = false;
+    const char *samplesName = nullptr;
+    const char *configName = nullptr;
+    std::uint64_t from = 0;
+    std::uint64_t to = std::numeric_limits<std::uint64_t>::max();
+    std::vector<const char *> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if (std::strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            samplesName = argv[++i];
+        } else if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            configName = argv[++i];
+        } else if (std::strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            char *end;
+            double fromSeconds = std::strtod(argv[++i], &end);
+            double toSeconds = *end == ':' ? std::strtod(end + 1, &end) : -1;
+            if (*end != '\0' || fromSeconds < 0 || toSeconds < fromSeconds) {
+                std::cerr << "invalid window " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+            from = static_cast<std::uint64_t>(fromSeconds * 1e9);
+            to = static_cast<std::uint64_t>(toSeconds * 1e9);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    std::string recordingName = args.size() > 0 ? args[0] : "market_data.bin";
+    std::string limitsName = args.size() > 1 ? args[1] : "exchange.json";
+
+    BookFileHeader header{};
+    std::vector<BookRecord> records;
+    try {
+        records = LoadRecording(recordingName, header, from, to);
+    } catch (const ReadyTraderGo::ReadyTraderGoError &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    boost::log::core::get()->set_logging_enabled(verbose);
+#ifdef RTG_HOT_LOG_BINARY
+    if (verbose) {
+        HotLogRing::Instance().Start();
+    }
+#endif
+
+    ExchangeLimits limits = LoadExchangeLimits(limitsName);
+    ReplayExchange exchange(limits);
+    StrategyParameters parameters;
+    if (configName != nullptr) {
+        parameters.sizing = LoadSizingCurveParameters(configName);
+        parameters.arbitrage = LoadArbitrageParameters(configName);
+    }
+    Strategy strategy(exchange, limits, parameters);
+    exchange.Attach(strategy);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const BookRecord &record : records) {
+        exchange.Replay(record);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+#ifdef RTG_HOT_LOG_BINARY
+    HotLogRing::Instance().Stop();
+#endif
+
+    const ReplayStats &stats = exchange.Stats();
+    std::cout << "events: " << stats.events << '\n'
+              << "messages: " << stats.messages << " (" << stats.inserts
+              << " inserts, " << stats.amends << " amends, " << stats.cancels
+              << " cancels, " << stats.hedges << " hedges)\n"
+              << "fills: " << stats.fills << " for " << stats.filledVolume
+              << " lots\n"
+              << "errors: " << stats.errors << '\n'
+              << "feed: " << strategy.Feed().Missing() << " missing, "
+              << strategy.Feed().Reordered() << " out of order\n"
+              << "rate limit breaches: " << stats.rateBreaches << '\n'
+              << "position limit breaches: " << stats.positionBreaches << '\n'
+              << "final position: etf " << exchange.EtfPosition()
+              << ", future " << exchange.FuturePosition() << '\n'
+              << "profit or loss: " << exchange.ProfitOrLoss() << " cents\n"
+              << "strategy's profit or loss: "
+              << strategy.Accounts().ProfitOrLoss() << " cents ("
+              << strategy.Accounts().MakerFees() << " maker fees, "
+              << strategy.Accounts().TakerFees() << " taker fees)\n"
+              << "time: " << elapsed << " ns ("
+              << (stats.events == 0 ? 0 : elapsed / stats.events)
+              << " ns/event)" << std::endl;
+#ifdef RTG_LATENCY_PROBES
+    strategy.Latency().Report(std::cout);
+#endif
+    if (samplesName != nullptr) {
+        try {
+            WriteAccountingSamples(samplesName, strategy.Accounts());
+        } catch (const ReadyTraderGo::ReadyTraderGoError &e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
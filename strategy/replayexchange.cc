@@ -0,0 +1,425 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <ready_trader_go/error.h>
+
+#include "bookstore.h"
+#include "replayexchange.h"
+#include "tradingconstants.h"
+
+using namespace ReadyTraderGo;
+
+// Adds a time relative to the start of a recording to its start, saturating
+static std::uint64_t After(std::uint64_t start, std::uint64_t offset) {
+    return offset > std::numeric_limits<std::uint64_t>::max() - start
+               ? std::numeric_limits<std::uint64_t>::max()
+               : start + offset;
+}
+
+std::vector<BookRecord> LoadRecording(const std::string &filename,
+                                      BookFileHeader &header,
+                                      std::uint64_t from, std::uint64_t to) {
+    std::vector<BookRecord> records;
+    if (IsBookStore(filename)) {
+        BookStoreReader store(filename);
+        header = store.Header().source;
+        store.Read(records, After(header.monotonicAtStart, from),
+                   After(header.monotonicAtStart, to));
+        return records;
+    }
+
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw ReadyTraderGoError("unable to open recording " + filename);
+    }
+    auto size = static_cast<std::size_t>(in.tellg());
+    in.seekg(0);
+
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in ||
+        std::memcmp(header.magic, BOOK_RECORD_MAGIC, sizeof(header.magic)) !=
+            0) {
+        throw ReadyTraderGoError(filename + " is not a book recording");
+    }
+    if (header.version != BOOK_RECORD_VERSION ||
+        header.recordSize != sizeof(BookRecord)) {
+        throw ReadyTraderGoError(filename + " has unsupported version " +
+                                 std::to_string(header.version));
+    }
+
+    records.resize((size - sizeof(header)) / sizeof(BookRecord));
+    in.read(reinterpret_cast<char *>(records.data()),
+            records.size() * sizeof(BookRecord));
+    if (!in) {
+        throw ReadyTraderGoError("unable to read " + filename);
+    }
+
+    std::uint64_t begin = After(header.monotonicAtStart, from);
+    std::uint64_t end = After(header.monotonicAtStart, to);
+    records.erase(std::remove_if(records.begin(), records.end(),
+                                 [begin, end](const BookRecord &record) {
+                                     return record.timestamp < begin ||
+                                            record.timestamp >= end;
+                                 }),
+                  records.end());
+    return records;
+}
+
+ReplayExchange::ReplayExchange(const ExchangeLimits &limits)
+    : mLimits(limits) {
+    mCallbacks.reserve(64);
+}
+
+void ReplayExchange::Replay(const BookRecord &record) {
+    mNow = record.timestamp;
+    mStats.events++;
+
+    auto instrument = static_cast<Instrument>(record.instrument);
+    Book levels;
+    std::copy(std::begin(record.askPrices), std::end(record.askPrices),
+              levels.askPrices.begin());
+    std::copy(std::begin(record.askVolumes), std::end(record.askVolumes),
+              levels.askVolumes.begin());
+    std::copy(std::begin(record.bidPrices), std::end(record.bidPrices),
+              levels.bidPrices.begin());
+    std::copy(std::begin(record.bidVolumes), std::end(record.bidVolumes),
+              levels.bidVolumes.begin());
+
+    if (record.kind == RecordKind::ORDER_BOOK) {
+        if (instrument == Instrument::ETF) {
+            mEtf = levels;
+            MatchBook();
+        } else {
+            mFuture = levels;
+        }
+        Deliver();
+        mStrategy->OrderBookMessageHandler(
+            instrument, record.sequenceNumber, levels.askPrices,
+            levels.askVolumes, levels.bidPrices, levels.bidVolumes);
+    } else {
+        if (instrument == Instrument::ETF) {
+            MatchTrades(levels.askPrices, levels.askVolumes, levels.bidPrices,
+                        levels.bidVolumes);
+        }
+        Deliver();
+        mStrategy->TradeTicksMessageHandler(
+            instrument, record.sequenceNumber, levels.askPrices,
+            levels.askVolumes, levels.bidPrices, levels.bidVolumes);
+    }
+    Deliver();
+
+    if (std::labs(mEtfPosition) > mLimits.positionLimit) {
+        mStats.positionBreaches++;
+    }
+}
+
+void ReplayExchange::SendAmendOrder(unsigned long clientOrderId,
+                                    unsigned long volume) {
+    Account();
+    mStats.amends++;
+
+    RestingOrder *order = mOrders.Find(clientOrderId);
+    if (order == nullptr) {
+        QueueError(clientOrderId, "out-of-date or unknown order");
+        return;
+    }
+    if (volume > order->volume) {
+        QueueError(clientOrderId, "amend would increase the order volume");
+        return;
+    }
+
+    // The new volume includes what has already traded.
+    order->volume = std::max(volume, order->filledVolume);
+    order->remainingVolume = order->volume - order->filledVolume;
+    QueueStatus(clientOrderId, *order);
+    if (order->remainingVolume == 0) {
+        mOrders.Erase(order);
+    }
+}
+
+void ReplayExchange::SendCancelOrder(unsigned long clientOrderId) {
+    Account();
+    mStats.cancels++;
+
+    RestingOrder *order = mOrders.Find(clientOrderId);
+    if (order == nullptr) {
+        QueueError(clientOrderId, "out-of-date or unknown order");
+        return;
+    }
+    order->remainingVolume = 0;
+    QueueStatus(clientOrderId, *order);
+    mOrders.Erase(order);
+}
+
+void ReplayExchange::SendHedgeOrder(unsigned long clientOrderId, Side side,
+                                    unsigned long price,
+                                    unsigned long volume) {
+    Account();
+    mStats.hedges++;
+
+    bool buy = side == Side::BUY;
+    Levels &prices = buy ? mFuture.askPrices : mFuture.bidPrices;
+    Levels &volumes = buy ? mFuture.askVolumes : mFuture.bidVolumes;
+
+    unsigned long filled = 0;
+    unsigned long notional = 0;
+    for (int i = 0; i < TOP_LEVEL_COUNT && filled < volume; i++) {
+        if (prices[i] == 0 || (buy ? prices[i] > price : prices[i] < price)) {
+            break;
+        }
+        unsigned long traded = std::min(volume - filled, volumes[i]);
+        volumes[i] -= traded;
+        filled += traded;
+        notional += traded * prices[i];
+    }
+
+    if (buy) {
+        mFuturePosition += filled;
+        mCash -= notional;
+    } else {
+        mFuturePosition -= filled;
+        mCash += notional;
+    }
+    mCallbacks.push_back({CallbackType::HEDGE_FILLED, clientOrderId,
+                          filled == 0 ? 0 : notional / filled, filled, 0, 0,
+                          nullptr});
+}
+
+void ReplayExchange::SendInsertOrder(unsigned long clientOrderId, Side side,
+                                     unsigned long price,
+                                     unsigned long volume,
+                                     Lifespan lifespan) {
+    Account();
+    mStats.inserts++;
+
+    if (volume == 0 || price % TICK_SIZE_IN_CENTS != 0) {
+        QueueError(clientOrderId, "invalid price or volume");
+        return;
+    }
+    if (mOrders.Size() >= mLimits.activeOrderCountLimit || mOrders.Full()) {
+        QueueError(clientOrderId, "active order count limit breached");
+        return;
+    }
+    unsigned long activeVolume = volume;
+    for (auto &[id, resting] : mOrders) {
+        activeVolume += resting.remainingVolume;
+    }
+    if (activeVolume > mLimits.activeVolumeLimit) {
+        QueueError(clientOrderId, "active order volume limit breached");
+        return;
+    }
+
+    RestingOrder *order =
+        mOrders.Insert(clientOrderId, {side, price, volume, 0, volume, 0});
+    Take(clientOrderId, *order);
+
+    // Every fill already reported the order's status.
+    if (order->remainingVolume != 0 && lifespan == Lifespan::FILL_AND_KILL) {
+        order->remainingVolume = 0;
+        QueueStatus(clientOrderId, *order);
+    } else if (order->filledVolume == 0) {
+        QueueStatus(clientOrderId, *order);
+    }
+    if (order->remainingVolume == 0) {
+        mOrders.Erase(order);
+    }
+}
+
+long ReplayExchange::ProfitOrLoss() const {
+    return mCash + mEtfPosition * static_cast<long>(Mid(mEtf)) +
+           mFuturePosition * static_cast<long>(Mid(mFuture));
+}
+
+void ReplayExchange::Account() {
+    mStats.messages++;
+    while (!mSendTimes.empty() &&
+           mSendTimes.front() + mLimits.messageFrequencyInterval <= mNow) {
+        mSendTimes.pop_front();
+    }
+    if (mSendTimes.size() >= mLimits.messageFrequencyLimit) {
+        mStats.rateBreaches++;
+    }
+    mSendTimes.push_back(mNow);
+}
+
+void ReplayExchange::Fill(unsigned long clientOrderId, RestingOrder &order,
+                          unsigned long price, unsigned long volume,
+                          double feeRate) {
+    long notional = static_cast<long>(price * volume);
+    long fee = std::lround(notional * feeRate);
+
+    order.filledVolume += volume;
+    order.remainingVolume -= volume;
+    order.fees += fee;
+    if (order.side == Side::SELL) {
+        mEtfPosition -= volume;
+        mCash += notional;
+    } else {
+        mEtfPosition += volume;
+        mCash -= notional;
+    }
+    mCash -= fee;
+
+    mStats.fills++;
+    mStats.filledVolume += volume;
+    mCallbacks.push_back({CallbackType::ORDER_FILLED, clientOrderId, price,
+                          volume, 0, 0, nullptr});
+    QueueStatus(clientOrderId, order);
+}
+
+void ReplayExchange::Take(unsigned long clientOrderId, RestingOrder &order) {
+    bool buy = order.side == Side::BUY;
+    Levels &prices = buy ? mEtf.askPrices : mEtf.bidPrices;
+    Levels &volumes = buy ? mEtf.askVolumes : mEtf.bidVolumes;
+
+    for (int i = 0; i < TOP_LEVEL_COUNT && order.remainingVolume != 0; i++) {
+        if (prices[i] == 0 ||
+            (buy ? prices[i] > order.price : prices[i] < order.price)) {
+            break;
+        }
+        unsigned long traded = std::min(order.remainingVolume, volumes[i]);
+        if (traded != 0) {
+            // The liquidity we take stays gone until the next book update.
+            volumes[i] -= traded;
+            Fill(clientOrderId, order, prices[i], traded, mLimits.takerFee);
+        }
+    }
+}
+
+void ReplayExchange::MatchBook() {
+    for (auto &[id, order] : mOrders) {
+        bool buy = order.side == Side::BUY;
+        Levels &prices = buy ? mEtf.askPrices : mEtf.bidPrices;
+        Levels &volumes = buy ? mEtf.askVolumes : mEtf.bidVolumes;
+        for (int i = 0; i < TOP_LEVEL_COUNT && order.remainingVolume != 0;
+             i++) {
+            if (prices[i] == 0 ||
+                (buy ? prices[i] > order.price : prices[i] < order.price)) {
+                break;
+            }
+            unsigned long traded =
+                std::min(order.remainingVolume, volumes[i]);
+            if (traded != 0) {
+                volumes[i] -= traded;
+                Fill(id, order, order.price, traded, mLimits.makerFee);
+            }
+        }
+    }
+
+    // Erasing moves entries around, so it is left until matching is done.
+    for (auto it = mOrders.begin(); it != mOrders.end();) {
+        if (it->order.remainingVolume == 0) {
+            mOrders.Erase(&it->order);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ReplayExchange::MatchTrades(const Levels &askPrices,
+                                 const Levels &askVolumes,
+                                 const Levels &bidPrices,
+                                 const Levels &bidVolumes) {
+    // Buyers that traded at or above our ask would have traded with us
+    // first, and likewise for sellers at or below our bid.
+    Levels remainingAsk = askVolumes;
+    Levels remainingBid = bidVolumes;
+    for (auto &[id, order] : mOrders) {
+        bool buy = order.side == Side::BUY;
+        const Levels &prices = buy ? bidPrices : askPrices;
+        Levels &volumes = buy ? remainingBid : remainingAsk;
+        for (int i = 0; i < TOP_LEVEL_COUNT && order.remainingVolume != 0;
+             i++) {
+            if (prices[i] == 0) {
+                break;
+            }
+            if (buy ? prices[i] > order.price : prices[i] < order.price) {
+                continue;
+            }
+            unsigned long traded =
+                std::min(order.remainingVolume, volumes[i]);
+            if (traded != 0) {
+                volumes[i] -= traded;
+                Fill(id, order, order.price, traded, mLimits.makerFee);
+            }
+        }
+    }
+
+    for (auto it = mOrders.begin(); it != mOrders.end();) {
+        if (it->order.remainingVolume == 0) {
+            mOrders.Erase(&it->order);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ReplayExchange::QueueStatus(unsigned long clientOrderId,
+                                 const RestingOrder &order) {
+    mCallbacks.push_back({CallbackType::ORDER_STATUS, clientOrderId, 0,
+                          order.filledVolume, order.remainingVolume,
+                          order.fees, nullptr});
+}
+
+void ReplayExchange::QueueError(unsigned long clientOrderId,
+                                const char *error) {
+    mStats.errors++;
+    mCallbacks.push_back(
+        {CallbackType::ERROR, clientOrderId, 0, 0, 0, 0, error});
+}
+
+void ReplayExchange::Deliver() {
+    // Handlers may send more messages, and so queue more callbacks, while
+    // this loop runs.
+    for (std::size_t i = 0; i < mCallbacks.size(); i++) {
+        Callback callback = mCallbacks[i];
+        switch (callback.type) {
+        case CallbackType::ERROR:
+            mStrategy->ErrorMessageHandler(callback.clientOrderId,
+                                           callback.error);
+            break;
+        case CallbackType::HEDGE_FILLED:
+            mStrategy->HedgeFilledMessageHandler(
+                callback.clientOrderId, callback.price, callback.volume);
+            break;
+        case CallbackType::ORDER_FILLED:
+            mStrategy->OrderFilledMessageHandler(
+                callback.clientOrderId, callback.price, callback.volume);
+            break;
+        case CallbackType::ORDER_STATUS:
+            mStrategy->OrderStatusMessageHandler(
+                callback.clientOrderId, callback.volume,
+                callback.remainingVolume, callback.fees);
+            break;
+        }
+    }
+    mCallbacks.clear();
+}
+
+unsigned long ReplayExchange::Mid(const Book &book) {
+    unsigned long ask = book.askPrices[0];
+    unsigned long bid = book.bidPrices[0];
+    if (ask != 0 && bid != 0) {
+        return (ask + bid) / 2;
+    }
+    return ask != 0 ? ask : bid;
+}
@@ -0,0 +1,193 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_REPLAYEXCHANGE_H
+#define CPPREADY_TRADER_GO_REPLAYEXCHANGE_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+#include "bookrecord.h"
+#include "exchangelimits.h"
+#include "executiongateway.h"
+#include "ordertable.h"
+#include "strategy.h"
+
+// Reads a recording made by agg/, or a book store made from one, into
+// memory. Only the records captured in [from, to) nanoseconds after the
+// recording started are kept; for a store, only the blocks holding them
+// are read. Throws ReadyTraderGoError if the file cannot be read or has a
+// different layout.
+std::vector<BookRecord>
+LoadRecording(const std::string &filename, BookFileHeader &header,
+              std::uint64_t from = 0,
+              std::uint64_t to = std::numeric_limits<std::uint64_t>::max());
+
+struct ReplayStats {
+    unsigned long events = 0;
+    unsigned long messages = 0;
+    unsigned long inserts = 0;
+    unsigned long amends = 0;
+    unsigned long cancels = 0;
+    unsigned long hedges = 0;
+    unsigned long fills = 0;
+    unsigned long filledVolume = 0;
+    unsigned long errors = 0;
+
+    // Messages sent while the exchange's frequency limit was already used up
+    unsigned long rateBreaches = 0;
+    // Events after which the ETF position was outside the position limit
+    unsigned long positionBreaches = 0;
+};
+
+// Stands in for the exchange when recorded market data is run through the
+// strategy.
+//
+// Our orders only ever trade with the recorded market, which does not react
+// to them:
+//  - an insert that crosses the current ETF book trades immediately with the
+//    levels it crosses and pays the taker fee;
+//  - a resting order trades at its own price, with the maker fee, when the
+//    recorded ETF book moves through it or ETF trades print at or through
+//    it;
+//  - hedges trade immediately with the recorded future book.
+//
+// The fees are the ones in the limits, so they match the strategy's own
+// accounting whatever exchange configuration is replayed.
+//
+// Callbacks are queued and delivered once the handler that caused them
+// returns, as they would be by the real exchange. Nothing depends on the
+// wall clock, so a recording always produces the same result.
+class ReplayExchange : public ExecutionGateway {
+public:
+    explicit ReplayExchange(const ExchangeLimits &limits);
+
+    // Must be called before the first event is replayed.
+    void Attach(Strategy &strategy) { mStrategy = &strategy; }
+
+    // Passes one recorded message to the strategy and runs the matching
+    // that follows from it.
+    void Replay(const BookRecord &record);
+
+    void SendAmendOrder(unsigned long clientOrderId,
+                        unsigned long volume) override;
+    void SendCancelOrder(unsigned long clientOrderId) override;
+    void SendHedgeOrder(unsigned long clientOrderId, ReadyTraderGo::Side side,
+                        unsigned long price, unsigned long volume) override;
+    void SendInsertOrder(unsigned long clientOrderId, ReadyTraderGo::Side side,
+                         unsigned long price, unsigned long volume,
+                         ReadyTraderGo::Lifespan lifespan) override;
+
+    // The capture time of the message being replayed.
+    std::uint64_t Now() const override { return mNow; }
+
+    const ReplayStats &Stats() const { return mStats; }
+
+    long EtfPosition() const { return mEtfPosition; }
+    long FuturePosition() const { return mFuturePosition; }
+
+    // Cash (after fees) plus both positions marked at the latest mid
+    // prices, in cents.
+    long ProfitOrLoss() const;
+
+private:
+    using Levels = std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>;
+
+    struct Book {
+        Levels askPrices{};
+        Levels askVolumes{};
+        Levels bidPrices{};
+        Levels bidVolumes{};
+    };
+
+    struct RestingOrder {
+        ReadyTraderGo::Side side;
+        unsigned long price;
+        unsigned long volume;
+        unsigned long filledVolume;
+        unsigned long remainingVolume;
+        long fees;
+    };
+
+    enum class CallbackType : unsigned char {
+        ERROR,
+        HEDGE_FILLED,
+        ORDER_FILLED,
+        ORDER_STATUS
+    };
+
+    struct Callback {
+        CallbackType type;
+        unsigned long clientOrderId;
+        unsigned long price;
+        unsigned long volume;
+        unsigned long remainingVolume;
+        long fees;
+        const char *error;
+    };
+
+    // Counts a message against the frequency limit.
+    void Account();
+
+    // Trades volume lots of an order at price and queues its callbacks.
+    void Fill(unsigned long clientOrderId, RestingOrder &order,
+              unsigned long price, unsigned long volume, double feeRate);
+
+    // Trades an order with the levels of the ETF book it crosses.
+    void Take(unsigned long clientOrderId, RestingOrder &order);
+
+    // Trades resting orders that a recorded order book or trade ticks
+    // message shows the market moving through.
+    void MatchBook();
+    void MatchTrades(const Levels &askPrices, const Levels &askVolumes,
+                     const Levels &bidPrices, const Levels &bidVolumes);
+
+    void QueueStatus(unsigned long clientOrderId, const RestingOrder &order);
+    void QueueError(unsigned long clientOrderId, const char *error);
+    void Deliver();
+
+    static unsigned long Mid(const Book &book);
+
+    ExchangeLimits mLimits;
+    Strategy *mStrategy = nullptr;
+
+    std::uint64_t mNow = 0;
+
+    Book mEtf;
+    Book mFuture;
+
+    // Far more than the strategy is allowed to rest at once, so that limit
+    // breaches can be reported rather than hidden.
+    OrderTable<RestingOrder, 64> mOrders;
+    std::vector<Callback> mCallbacks;
+
+    std::deque<std::uint64_t> mSendTimes;
+
+    long mCash = 0;
+    long mEtfPosition = 0;
+    long mFuturePosition = 0;
+
+    ReplayStats mStats;
+};
+
+#endif // CPPREADY_TRADER_GO_REPLAYEXCHANGE_H
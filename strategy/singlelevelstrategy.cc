@@ -0,0 +1,240 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <array>
+#include <string>
+
+#include <ready_trader_go/logging.h>
+
+#include "allocationtracker.h"
+#include "hotlog.h"
+#include "singlelevelstrategy.h"
+#include "tradingconstants.h"
+
+using namespace ReadyTraderGo;
+
+RTG_INLINE_GLOBAL_LOGGER_WITH_CHANNEL(LG_AT, "AUTO")
+
+SingleLevelStrategy::SingleLevelStrategy(ExecutionGateway &gateway,
+                                         const ExchangeLimits &limits)
+    : mGateway(gateway), mLimits(limits),
+      mGovernor(mLimits.messageFrequencyLimit,
+                mLimits.messageFrequencyInterval, RATE_SAFETY_MARGIN,
+                RATE_CRITICAL_RESERVE),
+      mHedges(0, 1) {}
+
+void SingleLevelStrategy::DisconnectHandler() {
+    AllocationExemptScope exempt;
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << "execution connection lost; " << mGovernor.ThrottledCount()
+        << " messages were held back by the rate governor";
+}
+
+void SingleLevelStrategy::ErrorMessageHandler(
+    unsigned long clientOrderId, const std::string &errorMessage) {
+    {
+        AllocationExemptScope exempt;
+        RLOG(LG_AT, LogLevel::LL_INFO)
+            << "error with order " << clientOrderId << ": " << errorMessage;
+    }
+    if (clientOrderId != 0) {
+        DropOrder(clientOrderId);
+    }
+}
+
+void SingleLevelStrategy::DropOrder(unsigned long clientOrderId) {
+    Order *found = mAsks.Find(clientOrderId);
+    bool isSellOrder = found != nullptr;
+    if (!isSellOrder) {
+        found = mBids.Find(clientOrderId);
+    }
+    if (found == nullptr) {
+        return;
+    }
+
+    (isSellOrder ? mETFOrderPositionSell : mETFOrderPositionBuy) -=
+        found->remainingVolume;
+    Quote &quote = isSellOrder ? mAsk : mBid;
+    if (quote.id == clientOrderId) {
+        quote.id = 0;
+    }
+    (isSellOrder ? mAsks : mBids).Erase(found);
+}
+
+void SingleLevelStrategy::HedgeFilledMessageHandler(
+    unsigned long clientOrderId, unsigned long price, unsigned long volume) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "hedge order {} filled for {} lots at ${} average price in cents",
+            clientOrderId, volume, price);
+
+    mNow = mGateway.Now();
+    long filled = 0;
+    if (mHedges.Filled(clientOrderId, volume, mNow, filled)) {
+        SendPendingHedge();
+    }
+}
+
+void SingleLevelStrategy::OrderBookMessageHandler(
+    Instrument instrument, unsigned long sequenceNumber,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "order book received for {} instrument: ask prices: {}; ask "
+            "volumes: {}; bid prices: {}; bid volumes: {}",
+            InstrumentName(instrument), askPrices[0], askVolumes[0],
+            bidPrices[0], bidVolumes[0]);
+
+    mNow = mGateway.Now();
+    if (!mBooks.Update(instrument, sequenceNumber, askPrices, askVolumes,
+                       bidPrices, bidVolumes)) {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "received old order book information.");
+        return;
+    }
+
+    SendPendingHedge();
+
+    if (instrument != Instrument::FUTURE) {
+        return;
+    }
+
+    const BookSnapshot &future = mBooks.Future();
+    if (future.bestAsk != 0) {
+        Requote(Side::SELL, future.bestAsk + TICK_SIZE_IN_CENTS);
+    }
+    if (future.bestBid > TICK_SIZE_IN_CENTS) {
+        Requote(Side::BUY, future.bestBid - TICK_SIZE_IN_CENTS);
+    }
+}
+
+void SingleLevelStrategy::Requote(Side side, unsigned long newPrice) {
+    bool isSell = side == Side::SELL;
+    Quote &quote = isSell ? mAsk : mBid;
+    auto &sideTable = isSell ? mAsks : mBids;
+
+    if (quote.id != 0 && quote.price != newPrice) {
+        if (!mGovernor.TryAcquire(mNow, MessagePriority::CRITICAL)) {
+            return;
+        }
+        mGateway.SendCancelOrder(quote.id);
+        if (Order *order = sideTable.Find(quote.id)) {
+            order->cancelling = true;
+        }
+        quote.id = 0;
+    }
+
+    long lots = static_cast<long>(SINGLE_LEVEL_LOT_SIZE);
+    bool room = isSell ? mETFPosition - mETFOrderPositionSell - lots >=
+                             -POSITION_LIMIT
+                       : mETFPosition + mETFOrderPositionBuy + lots <=
+                             POSITION_LIMIT;
+    if (quote.id != 0 || !room || sideTable.Full() ||
+        !mGovernor.TryAcquire(mNow)) {
+        return;
+    }
+
+    quote.id = mNextMessageId++;
+    quote.price = newPrice;
+    mGateway.SendInsertOrder(quote.id, side, newPrice, SINGLE_LEVEL_LOT_SIZE,
+                             Lifespan::GOOD_FOR_DAY);
+    (isSell ? mETFOrderPositionSell : mETFOrderPositionBuy) += lots;
+    sideTable.Insert(quote.id, {newPrice, SINGLE_LEVEL_LOT_SIZE, 0});
+}
+
+void SingleLevelStrategy::OrderFilledMessageHandler(
+    unsigned long clientOrderId, unsigned long price, unsigned long volume) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO, "order filled message {} {} {}",
+            clientOrderId, price, volume);
+}
+
+void SingleLevelStrategy::OrderStatusMessageHandler(
+    unsigned long clientOrderId, unsigned long fillVolume,
+    unsigned long remainingVolume, signed long fees) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "order status message received {} {} {} {}", clientOrderId,
+            fillVolume, remainingVolume, fees);
+
+    mNow = mGateway.Now();
+    Order *found = mAsks.Find(clientOrderId);
+    bool isSellOrder = found != nullptr;
+    if (!isSellOrder) {
+        found = mBids.Find(clientOrderId);
+    }
+    if (found == nullptr) {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "received order status for order we are not tracking. id={}",
+                clientOrderId);
+        return;
+    }
+
+    Order &order = *found;
+    auto dFilled = fillVolume - order.filledVolume;
+    if (dFilled > 0) {
+        mETFPosition += isSellOrder ? -dFilled : dFilled;
+        mHedges.AddExposure(isSellOrder ? (long)dFilled : -(long)dFilled,
+                            mNow);
+        SendPendingHedge();
+    }
+
+    auto dRemaining = order.remainingVolume - remainingVolume;
+    (isSellOrder ? mETFOrderPositionSell : mETFOrderPositionBuy) -= dRemaining;
+
+    if (remainingVolume > 0) {
+        order.remainingVolume = remainingVolume;
+        order.filledVolume = fillVolume;
+        return;
+    }
+
+    Quote &quote = isSellOrder ? mAsk : mBid;
+    if (quote.id == clientOrderId) {
+        quote.id = 0;
+    }
+    (isSellOrder ? mAsks : mBids).Erase(&order);
+}
+
+void SingleLevelStrategy::SendPendingHedge() {
+    if (!mHedges.Due(mNow) ||
+        !mGovernor.TryAcquire(mNow, MessagePriority::CRITICAL)) {
+        return;
+    }
+
+    long volume = mHedges.Unhedged();
+    bool buy = volume > 0;
+    auto orderId = mNextMessageId++;
+    mGateway.SendHedgeOrder(orderId, buy ? Side::BUY : Side::SELL,
+                            buy ? MAX_ASK_NEAREST_TICK : MIN_BID_NEAREST_TICK,
+                            buy ? volume : -volume);
+    mHedges.Sent(orderId);
+}
+
+void SingleLevelStrategy::TradeTicksMessageHandler(
+    Instrument instrument, unsigned long sequenceNumber,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "trade ticks received for {} instrument: ask prices: {}; ask "
+            "volumes: {}; bid prices: {}; bid volumes: {}",
+            InstrumentName(instrument), askPrices[0], askVolumes[0],
+            bidPrices[0], bidVolumes[0]);
+
+    mNow = mGateway.Now();
+    SendPendingHedge();
+}
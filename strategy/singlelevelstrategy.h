@@ -0,0 +1,137 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_SINGLELEVELSTRATEGY_H
+#define CPPREADY_TRADER_GO_SINGLELEVELSTRATEGY_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <ready_trader_go/types.h>
+
+#include "bookcache.h"
+#include "exchangelimits.h"
+#include "executiongateway.h"
+#include "hedgemanager.h"
+#include "ordertable.h"
+#include "rategovernor.h"
+#include "strategy.h"
+
+// Volume of every order the single-level strategy sends
+constexpr unsigned long SINGLE_LEVEL_LOT_SIZE = 10;
+
+// Cancelled quotes stay tracked until the exchange confirms them, so a side
+// can briefly hold a few orders
+constexpr int SINGLE_LEVEL_MAX_ORDERS = 4;
+
+// The original strategy: one order on each side of the ETF, a tick outside
+// the future's touch, for a fixed lot size. A quote is cancelled and
+// replaced whenever its price moves, and every fill is hedged at once.
+//
+// It has the same handlers as Strategy, so either can be plugged into
+// BasicAutoTrader (see autotrader.h).
+class SingleLevelStrategy {
+public:
+    SingleLevelStrategy(ExecutionGateway &gateway,
+                        const ExchangeLimits &limits);
+
+    void DisconnectHandler();
+
+    void ErrorMessageHandler(unsigned long clientOrderId,
+                             const std::string &errorMessage);
+
+    void HedgeFilledMessageHandler(unsigned long clientOrderId,
+                                   unsigned long price, unsigned long volume);
+
+    void OrderBookMessageHandler(
+        ReadyTraderGo::Instrument instrument, unsigned long sequenceNumber,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askVolumes,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidVolumes);
+
+    void OrderFilledMessageHandler(unsigned long clientOrderId,
+                                   unsigned long price, unsigned long volume);
+
+    void OrderStatusMessageHandler(unsigned long clientOrderId,
+                                   unsigned long fillVolume,
+                                   unsigned long remainingVolume,
+                                   signed long fees);
+
+    void TradeTicksMessageHandler(
+        ReadyTraderGo::Instrument instrument, unsigned long sequenceNumber,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askVolumes,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidVolumes);
+
+    signed long EtfPosition() const { return mETFPosition; }
+    const HedgeManager &Hedges() const { return mHedges; }
+
+private:
+    // Our live quote on one side; an id of zero means there is none.
+    struct Quote {
+        unsigned long id = 0;
+        unsigned long price = 0;
+    };
+
+    // Cancels the side's quote if it is not at the new price, then quotes
+    // there if the position limit allows.
+    void Requote(ReadyTraderGo::Side side, unsigned long newPrice);
+
+    // Forgets an order the exchange rejected, releasing the volume it still
+    // had in the market without touching what it filled.
+    void DropOrder(unsigned long clientOrderId);
+
+    void SendPendingHedge();
+
+    ExecutionGateway &mGateway;
+    ExchangeLimits mLimits;
+
+    // The gateway's clock, read once as each event arrives, as Strategy
+    // does
+    std::uint64_t mNow = 0;
+
+    RateGovernor mGovernor;
+
+    unsigned long mNextMessageId = 1;
+
+    BookCache mBooks;
+
+    Quote mAsk;
+    Quote mBid;
+
+    signed long mETFOrderPositionSell = 0;
+    signed long mETFOrderPositionBuy = 0;
+    signed long mETFPosition = 0;
+
+    HedgeManager mHedges;
+
+    OrderTable<Order, SINGLE_LEVEL_MAX_ORDERS> mAsks;
+    OrderTable<Order, SINGLE_LEVEL_MAX_ORDERS> mBids;
+};
+
+#endif // CPPREADY_TRADER_GO_SINGLELEVELSTRATEGY_H
@@ -0,0 +1,76 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <cmath>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "price.h"
+#include "sizingcurve.h"
+
+SizingCurveParameters LoadSizingCurveParameters(const std::string &filename) {
+    SizingCurveParameters parameters;
+
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::read_json(filename, tree);
+    } catch (const boost::property_tree::json_parser_error &) {
+        return parameters;
+    }
+
+    parameters.divisor = tree.get("Sizing.Divisor", parameters.divisor);
+    parameters.curvature = tree.get("Sizing.Curvature", parameters.curvature);
+    parameters.skewBasis = tree.get("Sizing.SkewBasis", parameters.skewBasis);
+    parameters.skewCurvature =
+        tree.get("Sizing.SkewCurvature", parameters.skewCurvature);
+
+    return parameters;
+}
+
+// Bends the line y = x through (0, 0) and (1, 1) towards y = x * |x|
+static double Bend(double x, double curvature) {
+    return x * ((1.0 - curvature) + curvature * std::abs(x));
+}
+
+// An order's volume when there is room for the given number of lots under
+// the position limit. A straight line is a plain division of the room, so
+// the default is exactly the sizing we have always used. A negative
+// curvature can scale the room up, but an order never asks for more than
+// there is room for, or the exchange would reject it.
+static long Volume(long room, long divisor, double curvature) {
+    constexpr double MAX_ROOM = 2 * POSITION_LIMIT;
+    double scale = (1.0 - curvature) + curvature * (room / MAX_ROOM);
+    return std::min(room,
+                    static_cast<long>(std::floor(room * scale / divisor)));
+}
+
+SizingCurve::SizingCurve(const SizingCurveParameters &parameters) {
+    long divisor = std::max(1l, parameters.divisor);
+    double curvature = std::clamp(parameters.curvature, -1.0, 1.0);
+    double skewCurvature = std::clamp(parameters.skewCurvature, -1.0, 1.0);
+    // A lean of a whole price or more cannot be quoted
+    long skewBasis = std::clamp(parameters.skewBasis, MIN_BASIS, -MIN_BASIS);
+
+    for (long position = -LIMIT; position <= LIMIT; position++) {
+        std::size_t i = Index(position);
+        mAskVolume[i] = Volume(position + LIMIT, divisor, curvature);
+        mBidVolume[i] = Volume(LIMIT - position, divisor, curvature);
+        mSkewBasis[i] = -std::lround(
+            skewBasis * Bend(double(position) / LIMIT, skewCurvature));
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_SIZINGCURVE_H
+#define CPPREADY_TRADER_GO_SIZINGCURVE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "tradingconstants.h"
+
+// How the size of our orders and the skew of our quotes depend on our ETF
+// position. Read from the optional "Sizing" block of autotrader.json:
+//
+//     "Sizing": {
+//       "Divisor": 5,
+//       "Curvature": 0.5,
+//       "SkewBasis": 3,
+//       "SkewCurvature": 0.0
+//     }
+//
+// An order is for at most the room left under the position limit on its
+// side divided by Divisor. Curvature bends that line: at 0 the volume falls
+// in proportion to the room left, towards 1 it falls away quadratically as
+// the room runs out, and towards -1 it holds up until the limit is close.
+//
+// SkewBasis leans both quotes by up to that many basis points against our
+// position at the limit, so that the side that reduces it is the more
+// likely to trade; SkewCurvature bends it the same way, from linear at 0
+// to quadratic at 1. Zero turns the skew off.
+struct SizingCurveParameters {
+    long divisor = 5;
+    double curvature = 0.0;
+    long skewBasis = 0;
+    double skewCurvature = 0.0;
+};
+
+SizingCurveParameters LoadSizingCurveParameters(const std::string &filename);
+
+// The curves above, evaluated once for every position within the limit, so
+// sizing an order or skewing a quote is a single table load.
+class SizingCurve {
+public:
+    explicit SizingCurve(const SizingCurveParameters &parameters);
+
+    // The volume of a new ask and a new bid, in lots, when we hold the given
+    // ETF position
+    long AskVolume(long position) const { return mAskVolume[Index(position)]; }
+    long BidVolume(long position) const { return mBidVolume[Index(position)]; }
+
+    // How far to lean both quotes, in basis points
+    long SkewBasis(long position) const { return mSkewBasis[Index(position)]; }
+
+private:
+    static constexpr long LIMIT = POSITION_LIMIT;
+    static constexpr std::size_t POSITIONS = 2 * LIMIT + 1;
+
+    static std::size_t Index(long position) {
+        return std::clamp(position, -LIMIT, LIMIT) + LIMIT;
+    }
+
+    std::array<long, POSITIONS> mAskVolume{};
+    std::array<long, POSITIONS> mBidVolume{};
+    std::array<long, POSITIONS> mSkewBasis{};
+};
+
+#endif // CPPREADY_TRADER_GO_SIZINGCURVE_H
@@ -0,0 +1,720 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <string>
+
+#include <ready_trader_go/error.h>
+#include <ready_trader_go/logging.h>
+
+#include "allocationtracker.h"
+#include "hotlog.h"
+#include "strategy.h"
+#include "tradingconstants.h"
+
+using namespace ReadyTraderGo;
+
+RTG_INLINE_GLOBAL_LOGGER_WITH_CHANNEL(LG_AT, "AUTO")
+
+Strategy::Strategy(ExecutionGateway &gateway, const ExchangeLimits &limits,
+                   const StrategyParameters &parameters)
+    : mGateway(gateway), mLimits(limits), mParameters(parameters),
+      mGovernor(mLimits.messageFrequencyLimit,
+                mLimits.messageFrequencyInterval, RATE_SAFETY_MARGIN,
+                RATE_CRITICAL_RESERVE),
+      mFeed(std::max(1ul, mParameters.staleTicks) * mLimits.tickInterval),
+      mFlow(mParameters.flowHalfLife), mSizing(mParameters.sizing),
+      mArbitrage(mParameters.arbitrage, mLimits),
+      mHedges(mParameters.hedgeWindow, mParameters.hedgeThreshold) {
+    mParameters.orderDepth =
+        std::clamp(mParameters.orderDepth, 1ul, (unsigned long)MAX_ORDER_DEPTH);
+    mDepthAllowance = mParameters.orderDepth;
+}
+
+void Strategy::DisconnectHandler() {
+    AllocationExemptScope exempt;
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << "execution connection lost; " << mGovernor.ThrottledCount()
+        << " messages were held back by the rate governor";
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << "profit or loss " << mAccounting.ProfitOrLoss() << " cents, of "
+        << "which fees " << mAccounting.Fees() << " cents; etf position "
+        << mAccounting.Etf().position << ", future position "
+        << mAccounting.Future().position;
+    RLOG(LG_AT, LogLevel::LL_INFO)
+        << "information feed: " << mFeed.Missing() << " messages missed, "
+        << mFeed.Reordered() << " out of order";
+    try {
+        WriteAccountingSamples("accounting.csv", mAccounting);
+    } catch (const ReadyTraderGoError &e) {
+        RLOG(LG_AT, LogLevel::LL_ERROR) << e.what();
+    }
+    LogLatency("final");
+}
+
+void Strategy::ErrorMessageHandler(unsigned long clientOrderId,
+                                   const std::string &errorMessage) {
+    {
+        AllocationExemptScope exempt;
+        RLOG(LG_AT, LogLevel::LL_INFO)
+            << "error with order " << clientOrderId << ": " << errorMessage;
+    }
+    if (clientOrderId == 0) {
+        return;
+    }
+    mNow = mGateway.Now();
+    mLatency.Acknowledged(clientOrderId);
+    DropOrder(clientOrderId);
+}
+
+void Strategy::DropOrder(unsigned long clientOrderId) {
+    Order *found = mAsks.Find(clientOrderId);
+    bool isSellOrder = found != nullptr;
+    if (!isSellOrder) {
+        found = mBids.Find(clientOrderId);
+    }
+    if (found == nullptr) {
+        if (TakeOrder *take = mTakes.Find(clientOrderId)) {
+            (take->side == Side::SELL ? mETFOrderPositionSell
+                                      : mETFOrderPositionBuy) -=
+                take->remainingVolume;
+            mAskReprice.dirty = mBidReprice.dirty = true;
+            mTakes.Erase(take);
+            PublishMetrics();
+        }
+        return;
+    }
+
+    // Whatever the order filled was booked by its status messages; only the
+    // volume still resting goes
+    if (isSellOrder) {
+        mETFOrderPositionSell -= found->remainingVolume;
+        mETFOrderAskCount--;
+    } else {
+        mETFOrderPositionBuy -= found->remainingVolume;
+        mETFOrderBidCount--;
+    }
+    (isSellOrder ? mAskReprice : mBidReprice).dirty = true;
+    (isSellOrder ? mAsks : mBids).Erase(found);
+    PublishMetrics();
+}
+
+void Strategy::HedgeFilledMessageHandler(unsigned long clientOrderId,
+                                         unsigned long price,
+                                         unsigned long volume) {
+    mNow = mGateway.Now();
+    mLatency.Acknowledged(clientOrderId);
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "hedge order {} filled for {} lots at ${} average price in cents",
+            clientOrderId, volume, price);
+
+    // Anything the hedge did not fill is hedged again at once
+    long filled = 0;
+    if (mHedges.Filled(clientOrderId, volume, mNow, filled)) {
+        mAccounting.FutureFill(filled, price);
+        SendPendingHedge();
+        PullIfPaused();
+    }
+    PublishMetrics();
+}
+
+void Strategy::OrderBookMessageHandler(
+    Instrument instrument, unsigned long sequenceNumber,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
+    mLatency.BeginTick();
+    mNow = mGateway.Now();
+
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "order book received for {} instrument: ask prices: {}; ask "
+            "volumes: {}; bid prices: {}; bid volumes: {}",
+            InstrumentName(instrument), askPrices[0], askVolumes[0],
+            bidPrices[0], bidVolumes[0]);
+
+    // Both books are cached (each with its own sequence number) so that
+    // signals from either are available to the quoting and hedging logic.
+    if (!mFeed.Update(RecordKind::ORDER_BOOK, instrument, sequenceNumber,
+                      mNow) ||
+        !mBooks.Update(instrument, sequenceNumber, askPrices, askVolumes,
+                       bidPrices, bidVolumes)) {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "received old order book information.");
+        EndTick();
+        return;
+    }
+
+    mAccounting.Mark(mBooks.Etf().midPrice, mBooks.Future().midPrice);
+    mAccounting.Sample(mNow);
+    mArbitrage.UpdateBooks(mBooks);
+
+    // Send any hedge whose window has closed, or that the rate governor
+    // held back
+    SendPendingHedge();
+
+    TakeDislocation();
+
+    if (instrument != Instrument::FUTURE || QuotingPaused()) {
+        PullIfPaused();
+        EndTick();
+        return;
+    }
+
+    // Quote fewer levels as the message budget runs down, so the orders
+    // closest to the touch can still be maintained.
+    unsigned long remaining = mGovernor.Remaining(mNow);
+    unsigned long comfortable = mGovernor.Capacity() / 2;
+    unsigned long depthAllowance =
+        remaining >= comfortable
+            ? mParameters.orderDepth
+            : std::max(1ul, mParameters.orderDepth * remaining / comfortable);
+    if (depthAllowance != mDepthAllowance) {
+        mDepthAllowance = depthAllowance;
+        mAskReprice.dirty = mBidReprice.dirty = true;
+    }
+
+    // Lean both quotes the way the ETF has been trading, and against our
+    // position, but never so far down that a price would reach zero
+    long skew =
+        mParameters.flowSkewBasis * mFlow.Etf().imbalance / IMBALANCE_SCALE +
+        mSizing.SkewBasis(mETFPosition);
+    long askBasis = std::max(MIN_BASIS, mParameters.marginBasis + skew);
+    long bidBasis = std::max(MIN_BASIS, skew - mParameters.marginBasis);
+
+    const BookSnapshot &future = mBooks.Future();
+    unsigned long newAskPrice =
+        (future.bestAsk != 0) ? MultiplyBasis(future.bestAsk, askBasis, true)
+                              : 0;
+    unsigned long newBidPrice =
+        (future.bestBid != 0) ? MultiplyBasis(future.bestBid, bidBasis, false)
+                              : 0;
+
+    // A side whose target and orders are as they were on the last tick
+    // would plan nothing, so it is skipped
+    if (newAskPrice != 0 && mAskReprice.Needed(newAskPrice)) {
+        mAskReprice.Repriced(newAskPrice);
+        RepriceSellOrders(newAskPrice);
+    }
+    if (newBidPrice != 0 && mBidReprice.Needed(newBidPrice)) {
+        mBidReprice.Repriced(newBidPrice);
+        RepriceBuyOrders(newBidPrice);
+    }
+    mLatency.Decided();
+
+    // Send everything both sides want as one prioritized batch
+    mPlanner.Emit(*this);
+    EndTick();
+}
+
+void Strategy::RepriceSellOrders(unsigned long newAskPrice) {
+    // Asks run from the lowest price up: first those priced through the new
+    // ask, then any at it, then the rest
+    std::size_t levelBegin = mAsks.LevelBegin(newAskPrice);
+    std::size_t levelEnd = mAsks.LevelEnd(newAskPrice);
+
+    for (std::size_t i = 0; i < levelBegin; i++) {
+        auto &[orderId, order] = mAsks[i];
+        if (!order.cancelling) {
+            mPlanner.Cancel(Side::SELL, orderId, order.price,
+                            order.remainingVolume, newAskPrice - order.price,
+                            OrderActionUrgency::STALE_CANCEL);
+        }
+    }
+
+    Order *existingAsk = nullptr;
+    unsigned long existingAskId = 0;
+    for (std::size_t i = levelBegin; i < levelEnd; i++) {
+        if (!mAsks[i].order.cancelling) {
+            existingAsk = &mAsks[i].order;
+            existingAskId = mAsks[i].id;
+        }
+    }
+
+    // The order at the new price is never evicted, since it would only be
+    // re-entered on the next tick.
+    std::size_t worst = mAsks.Size();
+    while (worst > levelEnd && mAsks[worst - 1].order.cancelling) {
+        worst--;
+    }
+    if (worst > levelEnd && mETFOrderAskCount >= mParameters.orderDepth - 1) {
+        auto &[largestOrderId, largestOrder] = mAsks[worst - 1];
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "cancelling sell order {} @ {} to make room for other orders",
+                largestOrderId, largestOrder.price);
+        mPlanner.Cancel(Side::SELL, largestOrderId, largestOrder.price,
+                        largestOrder.remainingVolume,
+                        largestOrder.price - newAskPrice,
+                        OrderActionUrgency::EVICTION_CANCEL);
+    }
+
+    long orderVolume = mSizing.AskVolume(mETFPosition);
+
+    if (existingAsk != nullptr) {
+        // Our inventory has moved since the order was placed, so reduce it
+        // in place rather than losing its queue position.
+        if (orderVolume > 0 &&
+            existingAsk->remainingVolume > (unsigned long)orderVolume) {
+            mPlanner.Amend(Side::SELL, existingAskId, newAskPrice,
+                           orderVolume);
+        }
+        return;
+    }
+
+    if ((mETFPosition - mETFOrderPositionSell - orderVolume) <
+            -POSITION_LIMIT ||
+        mETFOrderAskCount >= mDepthAllowance) {
+        return;
+    }
+
+    mPlanner.Insert(Side::SELL, newAskPrice, orderVolume);
+}
+
+void Strategy::RepriceBuyOrders(unsigned long newBidPrice) {
+    // Bids run from the highest price down
+    std::size_t levelBegin = mBids.LevelBegin(newBidPrice);
+    std::size_t levelEnd = mBids.LevelEnd(newBidPrice);
+
+    for (std::size_t i = 0; i < levelBegin; i++) {
+        auto &[orderId, order] = mBids[i];
+        if (!order.cancelling) {
+            mPlanner.Cancel(Side::BUY, orderId, order.price,
+                            order.remainingVolume, order.price - newBidPrice,
+                            OrderActionUrgency::STALE_CANCEL);
+        }
+    }
+
+    Order *existingBid = nullptr;
+    unsigned long existingBidId = 0;
+    for (std::size_t i = levelBegin; i < levelEnd; i++) {
+        if (!mBids[i].order.cancelling) {
+            existingBid = &mBids[i].order;
+            existingBidId = mBids[i].id;
+        }
+    }
+
+    std::size_t worst = mBids.Size();
+    while (worst > levelEnd && mBids[worst - 1].order.cancelling) {
+        worst--;
+    }
+    if (worst > levelEnd && mETFOrderBidCount >= mParameters.orderDepth - 1) {
+        auto &[smallestOrderId, smallestOrder] = mBids[worst - 1];
+        mPlanner.Cancel(Side::BUY, smallestOrderId, smallestOrder.price,
+                        smallestOrder.remainingVolume,
+                        newBidPrice - smallestOrder.price,
+                        OrderActionUrgency::EVICTION_CANCEL);
+    }
+
+    long orderVolume = mSizing.BidVolume(mETFPosition);
+
+    if (existingBid != nullptr) {
+        if (orderVolume > 0 &&
+            existingBid->remainingVolume > (unsigned long)orderVolume) {
+            mPlanner.Amend(Side::BUY, existingBidId, newBidPrice, orderVolume);
+        }
+        return;
+    }
+
+    if ((mETFPosition + mETFOrderPositionBuy + orderVolume) > POSITION_LIMIT ||
+        mETFOrderBidCount >= mDepthAllowance) {
+        return;
+    }
+
+    mPlanner.Insert(Side::BUY, newBidPrice, orderVolume);
+}
+
+void Strategy::ExecuteOrderAction(const OrderAction &action) {
+    bool isSell = action.side == Side::SELL;
+    auto &sideTable = isSell ? mAsks : mBids;
+
+    // Actions that would change nothing are dropped before they are charged
+    // to the rate governor, so they never spend budget that inserts and
+    // hedges need
+    Order *order = nullptr;
+    if (action.type == OrderActionType::INSERT) {
+        // An order we could not track must never reach the market
+        if (sideTable.Full()) {
+            AllocationExemptScope exempt;
+            RLOG(LG_AT, LogLevel::LL_ERROR)
+                << "no room to track another " << (isSell ? "sell" : "buy")
+                << " order; insert at " << action.price << " dropped";
+            return;
+        }
+    } else {
+        // The exchange only lets an amend reduce an order
+        order = sideTable.Find(action.clientOrderId);
+        if (order == nullptr || order->cancelling ||
+            (action.type == OrderActionType::AMEND &&
+             action.volume >= order->remainingVolume)) {
+            return;
+        }
+    }
+
+    auto priority = action.urgency == OrderActionUrgency::STALE_CANCEL
+                        ? MessagePriority::CRITICAL
+                        : MessagePriority::NORMAL;
+    if (!mGovernor.TryAcquire(mNow, priority)) {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "rate governor held back action {} for order {}", action.type,
+                action.clientOrderId);
+        // Plan it again on the next tick
+        (isSell ? mAskReprice : mBidReprice).dirty = true;
+        return;
+    }
+
+    switch (action.type) {
+    case OrderActionType::CANCEL:
+        mGateway.SendCancelOrder(action.clientOrderId);
+        mLatency.Sent(action.clientOrderId);
+        order->cancelling = true;
+        break;
+    case OrderActionType::AMEND:
+        // Plans carry the volume we want left in the market, but the
+        // exchange takes the order's new total volume, including whatever
+        // has already traded. The order status message that follows adjusts
+        // our outstanding position, exactly as it does for a partial fill.
+        mGateway.SendAmendOrder(action.clientOrderId,
+                                order->filledVolume + action.volume);
+        mLatency.Sent(action.clientOrderId);
+        break;
+    case OrderActionType::INSERT: {
+        // Tracked (there is room, as checked above) before it is sent
+        auto orderId = mNextMessageId++;
+        sideTable.Insert(orderId, {action.price, action.volume, 0});
+        mGateway.SendInsertOrder(orderId, action.side, action.price,
+                                 action.volume, Lifespan::GOOD_FOR_DAY);
+        mLatency.Sent(orderId);
+        if (isSell) {
+            mETFOrderAskCount++;
+            mETFOrderPositionSell += action.volume;
+        } else {
+            mETFOrderBidCount++;
+            mETFOrderPositionBuy += action.volume;
+        }
+        break;
+    }
+    }
+}
+
+void Strategy::OrderFilledMessageHandler(unsigned long clientOrderId,
+                                         unsigned long price,
+                                         unsigned long volume) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO, "order filled message {} {} {}",
+            clientOrderId, price, volume);
+
+    // The exchange reports a fill before the order status that removes a
+    // completed order, so the order is still in one of the tables here.
+    const TakeOrder *take = nullptr;
+    if (mAsks.Contains(clientOrderId)) {
+        mAccounting.EtfFill(Side::SELL, price, volume);
+    } else if (mBids.Contains(clientOrderId)) {
+        mAccounting.EtfFill(Side::BUY, price, volume);
+    } else if ((take = mTakes.Find(clientOrderId)) != nullptr) {
+        mAccounting.EtfFill(take->side, price, volume);
+    } else {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "received fill for order we are not tracking. id={}",
+                clientOrderId);
+    }
+}
+
+void Strategy::OrderStatusMessageHandler(unsigned long clientOrderId,
+                                         unsigned long fillVolume,
+                                         unsigned long remainingVolume,
+                                         signed long fees) {
+    mNow = mGateway.Now();
+    mLatency.Acknowledged(clientOrderId);
+
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "order status message received {} {} {} {}", clientOrderId,
+            fillVolume, remainingVolume, fees);
+
+    Order *found = mAsks.Find(clientOrderId);
+    bool isSellOrder = found != nullptr;
+    if (!isSellOrder) {
+        found = mBids.Find(clientOrderId);
+    }
+    if (found == nullptr) {
+        if (TakeOrder *take = mTakes.Find(clientOrderId)) {
+            TakeStatus(*take, fillVolume, remainingVolume, fees);
+            PullIfPaused();
+            PublishMetrics();
+            return;
+        }
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "received order status for order we are not tracking. id={}",
+                clientOrderId);
+        return;
+    }
+
+    auto &sideTable = isSellOrder ? mAsks : mBids;
+    Order &order = *found;
+    (isSellOrder ? mAskReprice : mBidReprice).dirty = true;
+
+    if (fees != order.fees) {
+        mAccounting.Fee(fees - order.fees);
+        order.fees = fees;
+    }
+
+    // Update our futures position to make sure we are correctly hedged
+    auto dFilled = fillVolume - order.filledVolume;
+    if (dFilled > 0) {
+        mETFPosition += isSellOrder ? -dFilled : dFilled;
+        // Both sides are sized from our position
+        mAskReprice.dirty = mBidReprice.dirty = true;
+        mHedges.AddExposure(isSellOrder ? (long)dFilled : -(long)dFilled, mNow);
+        SendPendingHedge();
+    }
+
+    // Update the state
+    auto dRemaining = order.remainingVolume - remainingVolume;
+    if (isSellOrder) {
+        mETFOrderPositionSell -= dRemaining;
+    } else {
+        mETFOrderPositionBuy -= dRemaining;
+    }
+
+    if (remainingVolume > 0) {
+        order.remainingVolume = remainingVolume;
+        order.filledVolume = fillVolume;
+    } else {
+        if (isSellOrder) {
+            mETFOrderAskCount--;
+        } else {
+            mETFOrderBidCount--;
+        }
+        sideTable.Erase(&order);
+    }
+    PullIfPaused();
+    PublishMetrics();
+}
+
+void Strategy::TakeStatus(TakeOrder &take, unsigned long fillVolume,
+                          unsigned long remainingVolume, signed long fees) {
+    bool isSellOrder = take.side == Side::SELL;
+
+    if (fees != take.fees) {
+        mAccounting.Fee(fees - take.fees);
+        take.fees = fees;
+    }
+
+    auto dFilled = fillVolume - take.filledVolume;
+    if (dFilled > 0) {
+        mETFPosition += isSellOrder ? -dFilled : dFilled;
+        mAskReprice.dirty = mBidReprice.dirty = true;
+        mHedges.AddExposure(isSellOrder ? (long)dFilled : -(long)dFilled, mNow);
+        mHedges.Expedite();
+        SendPendingHedge();
+    }
+
+    auto dRemaining = take.remainingVolume - remainingVolume;
+    if (isSellOrder) {
+        mETFOrderPositionSell -= dRemaining;
+    } else {
+        mETFOrderPositionBuy -= dRemaining;
+    }
+    // The volume the take held back from the ladder is free again
+    if (dRemaining != 0) {
+        mAskReprice.dirty = mBidReprice.dirty = true;
+    }
+
+    if (remainingVolume > 0) {
+        take.remainingVolume = remainingVolume;
+        take.filledVolume = fillVolume;
+    } else {
+        mTakes.Erase(&take);
+    }
+}
+
+void Strategy::TakeDislocation() {
+    if (!mArbitrage.Enabled() || mTakes.Full() || QuotingPaused() ||
+        mETFOrderAskCount + mETFOrderBidCount + mTakes.Size() >=
+            mLimits.activeOrderCountLimit) {
+        return;
+    }
+
+    // Room under the position limit, and under the exchange's limit on the
+    // volume we have in the market
+    long volumeRoom = (long)mLimits.activeVolumeLimit - mETFOrderPositionBuy -
+                      mETFOrderPositionSell;
+    long buyRoom = std::min(
+        volumeRoom, POSITION_LIMIT - mETFPosition - mETFOrderPositionBuy);
+    long sellRoom = std::min(
+        volumeRoom, POSITION_LIMIT + mETFPosition - mETFOrderPositionSell);
+
+    ArbitrageTake take =
+        mArbitrage.Decide(mBooks.Etf(), mBooks.Future(), buyRoom, sellRoom);
+    if (take.volume == 0 ||
+        !mGovernor.TryAcquire(mNow, MessagePriority::NORMAL)) {
+        return;
+    }
+
+    // mTakes has room (checked above), so this cannot fail; it is tracked
+    // before it is sent all the same
+    auto orderId = mNextMessageId;
+    if (mTakes.Insert(orderId, {take.side, take.volume, 0}) == nullptr) {
+        AllocationExemptScope exempt;
+        RLOG(LG_AT, LogLevel::LL_ERROR)
+            << "no room to track another take; take dropped";
+        return;
+    }
+    mNextMessageId++;
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "taking {} lots of the etf at {} against a basis of {} cents",
+            take.volume, take.price, mArbitrage.Basis());
+    mGateway.SendInsertOrder(orderId, take.side, take.price, take.volume,
+                             Lifespan::FILL_AND_KILL);
+    mLatency.Sent(orderId);
+    if (take.side == Side::SELL) {
+        mETFOrderPositionSell += take.volume;
+    } else {
+        mETFOrderPositionBuy += take.volume;
+    }
+}
+
+void Strategy::SendPendingHedge() {
+    if (!mHedges.Due(mNow) ||
+        !mGovernor.TryAcquire(mNow, MessagePriority::CRITICAL)) {
+        return;
+    }
+
+    long volume = mHedges.Unhedged();
+    bool buy = volume > 0;
+    auto orderId = mNextMessageId++;
+    mGateway.SendHedgeOrder(orderId, buy ? Side::BUY : Side::SELL,
+                            buy ? MAX_ASK_NEAREST_TICK : MIN_BID_NEAREST_TICK,
+                            buy ? volume : -volume);
+    mLatency.Sent(orderId);
+    mHedges.Sent(orderId);
+}
+
+void Strategy::FlushHedges() {
+    mNow = mGateway.Now();
+    SendPendingHedge();
+    PullIfPaused();
+    PublishMetrics();
+}
+
+void Strategy::CheckFeed() {
+    mNow = mGateway.Now();
+    PullIfPaused();
+    PublishMetrics();
+}
+
+bool Strategy::QuotingPaused() const {
+    return mFeed.Stale(Instrument::FUTURE, mNow) || mHedges.Saturated();
+}
+
+void Strategy::PullIfPaused() {
+    if (!QuotingPaused()) {
+        return;
+    }
+    for (auto &[orderId, order] : mAsks) {
+        if (!order.cancelling) {
+            mPlanner.Cancel(Side::SELL, orderId, order.price,
+                            order.remainingVolume, 0,
+                            OrderActionUrgency::STALE_CANCEL);
+        }
+    }
+    for (auto &[orderId, order] : mBids) {
+        if (!order.cancelling) {
+            mPlanner.Cancel(Side::BUY, orderId, order.price,
+                            order.remainingVolume, 0,
+                            OrderActionUrgency::STALE_CANCEL);
+        }
+    }
+    if (!mPlanner.Empty()) {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "pulling our orders: future's book stale {}, {} lots "
+                "unhedged",
+                mFeed.Stale(Instrument::FUTURE, mNow), mHedges.Unhedged());
+        mPlanner.Emit(*this);
+        mAskReprice.dirty = mBidReprice.dirty = true;
+    }
+}
+
+void Strategy::EndTick() {
+    PublishMetrics();
+    if (mLatency.EndTick()) {
+        LogLatency("snapshot");
+    }
+}
+
+void Strategy::PublishMetrics() {
+    mMetrics.Set(Metric::ETF_POSITION, mETFPosition);
+    mMetrics.Set(Metric::FUTURE_POSITION, mAccounting.Future().position);
+    mMetrics.Set(Metric::ETF_BUY_EXPOSURE, mETFOrderPositionBuy);
+    mMetrics.Set(Metric::ETF_SELL_EXPOSURE, mETFOrderPositionSell);
+    mMetrics.Set(Metric::ASK_ORDERS, mETFOrderAskCount);
+    mMetrics.Set(Metric::BID_ORDERS, mETFOrderBidCount);
+    mMetrics.Set(Metric::UNHEDGED_VOLUME, mHedges.Unhedged());
+    mMetrics.Set(Metric::MESSAGE_BUDGET, mGovernor.Remaining(mNow));
+    mMetrics.Set(Metric::MESSAGES_THROTTLED, mGovernor.ThrottledCount());
+    mMetrics.Set(Metric::FEED_MISSING, mFeed.Missing());
+    mMetrics.Set(Metric::FEED_REORDERED, mFeed.Reordered());
+    mMetrics.Set(Metric::PROFIT_OR_LOSS, mAccounting.ProfitOrLoss());
+    mMetrics.Set(Metric::FEES, mAccounting.Fees());
+    mMetrics.Set(Metric::TICK_TO_DECISION,
+                 mLatency.Last(LatencyStage::TICK_TO_DECISION));
+    mMetrics.Set(Metric::TICK_TO_SEND,
+                 mLatency.Last(LatencyStage::TICK_TO_SEND));
+    mMetrics.Set(Metric::SEND_TO_ACK, mLatency.Last(LatencyStage::SEND_TO_ACK));
+}
+
+void Strategy::LogLatency(const char *label) const {
+#ifdef RTG_LATENCY_PROBES
+    AllocationExemptScope exempt;
+    std::ostringstream report;
+    mLatency.Report(report);
+    std::istringstream lines(report.str());
+    for (std::string line; std::getline(lines, line);) {
+        RLOG(LG_AT, LogLevel::LL_INFO) << label << " latency " << line;
+    }
+#endif
+}
+
+void Strategy::TradeTicksMessageHandler(
+    Instrument instrument, unsigned long sequenceNumber,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &askVolumes,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidPrices,
+    const std::array<unsigned long, TOP_LEVEL_COUNT> &bidVolumes) {
+    HOT_LOG(LG_AT, LogLevel::LL_INFO,
+            "trade ticks received for {} instrument: ask prices: {}; ask "
+            "volumes: {}; bid prices: {}; bid volumes: {}",
+            InstrumentName(instrument), askPrices[0], askVolumes[0],
+            bidPrices[0], bidVolumes[0]);
+
+    mNow = mGateway.Now();
+    if (mFeed.Update(RecordKind::TRADE_TICKS, instrument, sequenceNumber,
+                     mNow)) {
+        mFlow.Update(instrument, askPrices, askVolumes, bidPrices, bidVolumes);
+        if (instrument == Instrument::ETF) {
+            mArbitrage.UpdateTrades(askPrices, askVolumes, bidPrices,
+                                    bidVolumes, mBooks.Future());
+        }
+    } else {
+        HOT_LOG(LG_AT, LogLevel::LL_INFO,
+                "received old trade ticks information.");
+    }
+
+    SendPendingHedge();
+    PullIfPaused();
+    PublishMetrics();
+}
@@ -0,0 +1,311 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_STRATEGY_H
+#define CPPREADY_TRADER_GO_STRATEGY_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <ready_trader_go/types.h>
+
+#include "accounting.h"
+#include "bookcache.h"
+#include "etfarbitrage.h"
+#include "exchangelimits.h"
+#include "executiongateway.h"
+#include "feedmonitor.h"
+#include "hedgemanager.h"
+#include "latencyprobes.h"
+#include "livemetrics.h"
+#include "orderplanner.h"
+#include "price.h"
+#include "priceladder.h"
+#include "rategovernor.h"
+#include "sizingcurve.h"
+#include "tradeflow.h"
+
+// The most orders we can keep resting on each side of the book
+constexpr int MAX_ORDER_DEPTH = 5;
+
+// Per side: a cancel for every resting order, plus an insert and an amend
+constexpr int MAX_PLANNED_ACTIONS = 2 * (MAX_ORDER_DEPTH + 2);
+
+// The arbitrage takes again only once its last take has been answered
+constexpr int MAX_OUTSTANDING_TAKES = 1;
+
+// The tunable parts of the strategy. The defaults are what a match runs
+// with; the sweep tool replays recordings with other values.
+struct StrategyParameters {
+    // How far from the future's touch we quote the ETF, in basis points
+    long marginBasis = 7;
+
+    // How many orders we rest on each side, at most MAX_ORDER_DEPTH
+    unsigned long orderDepth = MAX_ORDER_DEPTH;
+
+    // How big our orders are and how far our quotes lean for each position
+    // (see sizingcurve.h)
+    SizingCurveParameters sizing;
+
+    // Fills are hedged together if they arrive within this many
+    // nanoseconds of the first unhedged one...
+    std::uint64_t hedgeWindow = 10'000'000;
+
+    // ...unless the unhedged volume reaches this many lots
+    unsigned long hedgeThreshold = 10;
+
+    // Our orders are pulled once the future's book has not been updated for
+    // this many of the exchange's tick intervals
+    unsigned long staleTicks = 4;
+
+    // Both quotes lean up to this many basis points towards the side the
+    // ETF's recent trades have been aggressive on; zero turns it off
+    long flowSkewBasis = 0;
+
+    // A trade's weight in the flow halves after this many trade ticks
+    // messages
+    unsigned long flowHalfLife = 8;
+
+    // When to take the ETF because it has come apart from the future (see
+    // etfarbitrage.h); off unless enabled
+    ArbitrageParameters arbitrage;
+};
+
+struct Order {
+
+    unsigned long price;
+
+    unsigned long remainingVolume;
+    unsigned long filledVolume;
+
+    bool cancelling = false;
+
+    // The fees the exchange has reported for the order so far
+    signed long fees = 0;
+};
+
+// A fill-and-kill order the arbitrage has sent to take the ETF
+struct TakeOrder {
+    ReadyTraderGo::Side side;
+
+    unsigned long remainingVolume;
+    unsigned long filledVolume;
+
+    signed long fees = 0;
+};
+
+// The target price one side of the book was last repriced against.
+// Repricing depends only on the target and our own orders and position, so
+// a side is repriced again only once its target moves or it is marked
+// dirty by a change to those.
+struct RepriceState {
+    unsigned long target = 0;
+    bool dirty = true;
+
+    bool Needed(unsigned long newTarget) const {
+        return dirty || newTarget != target;
+    }
+
+    void Repriced(unsigned long newTarget) {
+        target = newTarget;
+        dirty = false;
+    }
+};
+
+// The trading logic, independent of where market data comes from and where
+// orders go. The handlers have the same meaning as those of
+// ReadyTraderGo::BaseAutoTrader (see autotrader.h); everything is sent
+// through the gateway.
+class Strategy {
+public:
+    Strategy(ExecutionGateway &gateway, const ExchangeLimits &limits,
+             const StrategyParameters &parameters = StrategyParameters());
+
+    void DisconnectHandler();
+
+    void ErrorMessageHandler(unsigned long clientOrderId,
+                             const std::string &errorMessage);
+
+    void HedgeFilledMessageHandler(unsigned long clientOrderId,
+                                   unsigned long price, unsigned long volume);
+
+    void OrderBookMessageHandler(
+        ReadyTraderGo::Instrument instrument, unsigned long sequenceNumber,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askVolumes,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidVolumes);
+
+    // Plan the changes needed to quote at the new prices. The plan is sent
+    // once both sides have been repriced.
+    void RepriceBuyOrders(unsigned long newBidPrice);
+    void RepriceSellOrders(unsigned long newAskPrice);
+
+    void OrderFilledMessageHandler(unsigned long clientOrderId,
+                                   unsigned long price, unsigned long volume);
+
+    void OrderStatusMessageHandler(unsigned long clientOrderId,
+                                   unsigned long fillVolume,
+                                   unsigned long remainingVolume,
+                                   signed long fees);
+
+    void TradeTicksMessageHandler(
+        ReadyTraderGo::Instrument instrument, unsigned long sequenceNumber,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &askVolumes,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidPrices,
+        const std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>
+            &bidVolumes);
+
+    // Checks the feed between messages, so that our orders are pulled once
+    // the future's book goes stale even if nothing else arrives. The adapter
+    // calls it once every tick interval.
+    void CheckFeed();
+
+    // Sends a hedge held back by the aggregation window once it closes, and
+    // when that is, or zero if nothing is held back. The adapter arms a timer
+    // for the window's end, so the hedge need not wait for the next event.
+    void FlushHedges();
+    std::uint64_t HedgeWindowEnd() const { return mHedges.WindowEnd(); }
+
+    // The parameters in use, after out of range values have been clamped
+    const StrategyParameters &Parameters() const { return mParameters; }
+    const RateGovernor &Governor() const { return mGovernor; }
+    const LatencyProbes &Latency() const { return mLatency; }
+    signed long EtfPosition() const { return mETFPosition; }
+    const HedgeManager &Hedges() const { return mHedges; }
+    const Accounting &Accounts() const { return mAccounting; }
+    const FeedMonitor &Feed() const { return mFeed; }
+    const EtfArbitrage &Arbitrage() const { return mArbitrage; }
+    const TradeFlow &Flow() const { return mFlow; }
+    const LiveMetrics &Metrics() const { return mMetrics; }
+
+private:
+    template <std::size_t> friend class OrderPlanner;
+
+    // Sends one planned action and updates our view of the orders in the
+    // market to match.
+    void ExecuteOrderAction(const OrderAction &action);
+
+    // Hedges all our unhedged fills in one order once the hedge manager
+    // says it is due, unless the rate governor has no room for it, in which
+    // case it is retried on the next event.
+    void SendPendingHedge();
+
+    // Takes the ETF, if the arbitrage finds it worth it, as soon as either
+    // book shows it. Its fills are hedged at once, without waiting for the
+    // hedge window.
+    void TakeDislocation();
+
+    // Forgets an order or take the exchange rejected, releasing the volume
+    // it still had in the market. Its fills and fees stay as its last
+    // status left them: only status messages book fees.
+    void DropOrder(unsigned long clientOrderId);
+
+    // Handles the status of one of the arbitrage's takes.
+    void TakeStatus(TakeOrder &take, unsigned long fillVolume,
+                    unsigned long remainingVolume, signed long fees);
+
+    // Whether we should have no orders in the market: while the future's
+    // book is stale, since they were priced off it, or while the hedge
+    // manager is saturated, since every fill adds to what we cannot hedge.
+    bool QuotingPaused() const;
+
+    // Cancels all our orders while quoting is paused. Quoting resumes on the
+    // first update of the future's book after that.
+    void PullIfPaused();
+
+    // Ends the latency probes' tick and logs a snapshot when one is due.
+    void EndTick();
+
+    // Copies our state into the live metrics as an event finishes.
+    void PublishMetrics();
+    void LogLatency(const char *label) const;
+
+    ExecutionGateway &mGateway;
+    ExchangeLimits mLimits;
+    StrategyParameters mParameters;
+
+    // The gateway's clock, read once as each event arrives and used for
+    // everything the event sends, rather than once per order
+    std::uint64_t mNow = 0;
+
+    // Every message we send is accounted for here first
+    RateGovernor mGovernor;
+
+    LatencyProbes mLatency;
+
+    unsigned long mNextMessageId = 1;
+
+    OrderPlanner<MAX_PLANNED_ACTIONS> mPlanner;
+
+    // The latest order book for each instrument
+    BookCache mBooks;
+
+    FeedMonitor mFeed;
+
+    // Decayed traded volume and VWAP for each instrument
+    TradeFlow mFlow;
+
+    // Order volume and quote skew for each position
+    SizingCurve mSizing;
+
+    // The ETF's usual basis to the future, and when to trade against it
+    EtfArbitrage mArbitrage;
+    OrderTable<TakeOrder, MAX_OUTSTANDING_TAKES> mTakes;
+
+    // The change in the position we hold if all orders that have left our bot
+    // were filled either mETFPosition + mETFOrderPositionBuy > 100 or
+    // mETFPosition - mETFOrderPositionSell < 100 will disqualify our bot
+    signed long mETFOrderPositionSell = 0;
+    signed long mETFOrderPositionBuy = 0;
+
+    unsigned int mETFOrderAskCount = 0;
+    unsigned int mETFOrderBidCount = 0;
+
+    signed long mETFPosition = 0;
+
+    HedgeManager mHedges;
+
+    // Positions, profit and fees, from the fills the exchange reports
+    Accounting mAccounting;
+
+    // How many orders we are prepared to rest on each side at the moment
+    unsigned long mDepthAllowance;
+
+    // What each side was last repriced against
+    RepriceState mAskReprice;
+    RepriceState mBidReprice;
+
+    // Our state for monitoring from other threads
+    LiveMetrics mMetrics;
+
+    // We track the state of our orders that are currently in the market,
+    // each side from its best price to its worst
+    PriceLadder<Order, MAX_ORDER_DEPTH> mAsks{ReadyTraderGo::Side::SELL};
+    PriceLadder<Order, MAX_ORDER_DEPTH> mBids{ReadyTraderGo::Side::BUY};
+};
+
+#endif // CPPREADY_TRADER_GO_STRATEGY_H
@@ -0,0 +1,296 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+// Replays a recording made by agg/ once for every combination of strategy
+// parameters in a grid (or for a number of random samples from it), using
+// every core, and writes one row of results per run.
+//
+// Usage: sweep [-j THREADS] [-r SAMPLES] [-s SEED] [-m FROM:TO[:STEP]]
+//              [-d FROM:TO[:STEP]] [-z FROM:TO[:STEP]] [-k FROM:TO[:STEP]]
+//              RECORDING [OUTPUT]
+//
+//   -m  margin in basis points (default 0:20)
+//   -d  order depth (default 1:MAX_ORDER_DEPTH)
+//   -z  sizing divisor (default 1:10)
+//   -k  trade flow skew in basis points (default 0:0)
+//   -r  run this many random samples from the ranges instead of the grid
+//
+// Every range must hold at least one value, and depths and divisors outside
+// what the strategy accepts are refused rather than clamped.
+//
+// The results file is columnar: a header, the column names and then each
+// column's values as a contiguous array of 64-bit integers:
+//
+//     char magic[8] = "RTGSWEEP"
+//     uint32 version, uint32 columnCount, uint64 rowCount
+//     char name[24] * columnCount
+//     int64 value[rowCount] * columnCount
+//
+// The ten most profitable runs are also printed.
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/log/core.hpp>
+
+#include <ready_trader_go/error.h>
+
+#include "exchangelimits.h"
+#include "replayexchange.h"
+#include "strategy.h"
+#include "workstealingpool.h"
+
+constexpr char SWEEP_MAGIC[8] = {'R', 'T', 'G', 'S', 'W', 'E', 'E', 'P'};
+constexpr std::uint32_t SWEEP_VERSION = 1;
+constexpr std::size_t SWEEP_NAME_SIZE = 24;
+
+struct Range {
+    long from;
+    long to;
+    long step = 1;
+
+    long Count() const { return from > to ? 0 : (to - from) / step + 1; }
+};
+
+struct SweepResult {
+    StrategyParameters parameters;
+    long profitOrLoss;
+    long etfPosition;
+    long futurePosition;
+    ReplayStats stats;
+};
+
+static bool ParseRange(const char *text, Range &range,
+                       long min = std::numeric_limits<long>::min(),
+                       long max = std::numeric_limits<long>::max()) {
+    char *end;
+    range.from = std::strtol(text, &end, 10);
+    if (end == text || *end != ':') {
+        return false;
+    }
+    const char *to = end + 1;
+    range.to = std::strtol(to, &end, 10);
+    if (end == to) {
+        return false;
+    }
+    if (*end == ':') {
+        range.step = std::strtol(end + 1, &end, 10);
+    }
+    return *end == '\0' && range.step > 0 && range.from <= range.to &&
+           range.from >= min && range.to <= max;
+}
+
+static void WriteResults(const std::string &filename,
+                         const std::vector<SweepResult> &results) {
+    using Column = long (*)(const SweepResult &);
+    static const std::pair<const char *, Column> columns[] = {
+        {"margin_basis",
+         [](const SweepResult &r) { return r.parameters.marginBasis; }},
+        {"order_depth",
+         [](const SweepResult &r) { return (long)r.parameters.orderDepth; }},
+        {"sizing_divisor",
+         [](const SweepResult &r) { return r.parameters.sizing.divisor; }},
+        {"flow_skew_basis",
+         [](const SweepResult &r) { return r.parameters.flowSkewBasis; }},
+        {"profit_or_loss", [](const SweepResult &r) { return r.profitOrLoss; }},
+        {"etf_position", [](const SweepResult &r) { return r.etfPosition; }},
+        {"future_position",
+         [](const SweepResult &r) { return r.futurePosition; }},
+        {"messages", [](const SweepResult &r) { return (long)r.stats.messages; }},
+        {"fills", [](const SweepResult &r) { return (long)r.stats.fills; }},
+        {"filled_volume",
+         [](const SweepResult &r) { return (long)r.stats.filledVolume; }},
+        {"errors", [](const SweepResult &r) { return (long)r.stats.errors; }},
+        {"rate_breaches",
+         [](const SweepResult &r) { return (long)r.stats.rateBreaches; }},
+        {"position_breaches",
+         [](const SweepResult &r) { return (long)r.stats.positionBreaches; }},
+    };
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        throw ReadyTraderGo::ReadyTraderGoError("unable to create " +
+                                                filename);
+    }
+
+    std::uint32_t columnCount = std::size(columns);
+    std::uint64_t rowCount = results.size();
+    out.write(SWEEP_MAGIC, sizeof(SWEEP_MAGIC));
+    out.write(reinterpret_cast<const char *>(&SWEEP_VERSION),
+              sizeof(SWEEP_VERSION));
+    out.write(reinterpret_cast<const char *>(&columnCount),
+              sizeof(columnCount));
+    out.write(reinterpret_cast<const char *>(&rowCount), sizeof(rowCount));
+    for (const auto &[name, column] : columns) {
+        char padded[SWEEP_NAME_SIZE] = {};
+        std::strncpy(padded, name, SWEEP_NAME_SIZE - 1);
+        out.write(padded, SWEEP_NAME_SIZE);
+    }
+
+    std::vector<std::int64_t> values(results.size());
+    for (const auto &[name, column] : columns) {
+        std::transform(results.begin(), results.end(), values.begin(), column);
+        out.write(reinterpret_cast<const char *>(values.data()),
+                  values.size() * sizeof(std::int64_t));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t threads = std::thread::hardware_concurrency();
+    unsigned long samples = 0;
+    unsigned long seed = 1;
+    Range margins{0, 20};
+    Range depths{1, MAX_ORDER_DEPTH};
+    Range divisors{1, 10};
+    Range skews{0, 0};
+    std::vector<const char *> args;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (std::strcmp(argv[i], "-j") == 0 && hasValue) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-r") == 0 && hasValue) {
+            samples = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-s") == 0 && hasValue) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-m") == 0 && hasValue) {
+            valid = ParseRange(argv[++i], margins);
+        } else if (std::strcmp(argv[i], "-d") == 0 && hasValue) {
+            valid = ParseRange(argv[++i], depths, 1, MAX_ORDER_DEPTH);
+        } else if (std::strcmp(argv[i], "-z") == 0 && hasValue) {
+            valid = ParseRange(argv[++i], divisors, 1);
+        } else if (std::strcmp(argv[i], "-k") == 0 && hasValue) {
+            valid = ParseRange(argv[++i], skews);
+        } else if (argv[i][0] != '-') {
+            args.push_back(argv[i]);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << "usage: sweep [-j THREADS] [-r SAMPLES] [-s SEED] "
+                         "[-m FROM:TO[:STEP]] [-d FROM:TO[:STEP]] "
+                         "[-z FROM:TO[:STEP]] [-k FROM:TO[:STEP]] "
+                         "RECORDING [OUTPUT]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (args.empty()) {
+        std::cerr << "no recording given" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string outputName = args.size() > 1 ? args[1] : "sweep_results.bin";
+
+    BookFileHeader header{};
+    std::vector<BookRecord> records;
+    try {
+        records = LoadRecording(args[0], header);
+    } catch (const ReadyTraderGo::ReadyTraderGoError &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<StrategyParameters> runs;
+    if (samples != 0) {
+        std::mt19937_64 rng(seed);
+        auto pick = [&rng](const Range &range) {
+            std::uniform_int_distribution<long> index(0, range.Count() - 1);
+            return range.from + index(rng) * range.step;
+        };
+        for (unsigned long i = 0; i < samples; i++) {
+            StrategyParameters run;
+            run.marginBasis = pick(margins);
+            run.orderDepth = pick(depths);
+            run.sizing.divisor = pick(divisors);
+            run.flowSkewBasis = pick(skews);
+            runs.push_back(run);
+        }
+    } else {
+        for (long m = margins.from; m <= margins.to; m += margins.step) {
+            for (long d = depths.from; d <= depths.to; d += depths.step) {
+                for (long z = divisors.from; z <= divisors.to;
+                     z += divisors.step) {
+                    for (long k = skews.from; k <= skews.to; k += skews.step) {
+                        StrategyParameters run;
+                        run.marginBasis = m;
+                        run.orderDepth = d;
+                        run.sizing.divisor = z;
+                        run.flowSkewBasis = k;
+                        runs.push_back(run);
+                    }
+                }
+            }
+        }
+    }
+
+    boost::log::core::get()->set_logging_enabled(false);
+
+    // Every run gets its own exchange and strategy; only the recording is
+    // shared, and it is never written.
+    ExchangeLimits limits = LoadExchangeLimits("exchange.json");
+    std::vector<SweepResult> results(runs.size());
+    WorkStealingPool pool(threads);
+    pool.Run(runs.size(), [&](std::size_t index, std::size_t) {
+        ReplayExchange exchange(limits);
+        Strategy strategy(exchange, limits, runs[index]);
+        exchange.Attach(strategy);
+        for (const BookRecord &record : records) {
+            exchange.Replay(record);
+        }
+        results[index] = {strategy.Parameters(), exchange.ProfitOrLoss(),
+                          exchange.EtfPosition(), exchange.FuturePosition(),
+                          exchange.Stats()};
+    });
+
+    try {
+        WriteResults(outputName, results);
+    } catch (const ReadyTraderGo::ReadyTraderGoError &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<const SweepResult *> ranked;
+    for (const SweepResult &result : results) {
+        ranked.push_back(&result);
+    }
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const SweepResult *a, const SweepResult *b) {
+                         return a->profitOrLoss > b->profitOrLoss;
+                     });
+
+    std::cout << runs.size() << " runs on " << pool.ThreadCount()
+              << " threads written to " << outputName << '\n'
+              << "margin depth sizing skew     pnl  fills  breaches\n";
+    for (std::size_t i = 0; i < ranked.size() && i < 10; i++) {
+        const SweepResult &r = *ranked[i];
+        std::cout << r.parameters.marginBasis << ' ' << r.parameters.orderDepth
+                  << ' ' << r.parameters.sizing.divisor << ' '
+                  << r.parameters.flowSkewBasis << ' ' << r.profitOrLoss
+                  << ' ' << r.stats.fills << ' '
+                  << r.stats.rateBreaches + r.stats.positionBreaches << '\n';
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_TRADEFLOW_H
+#define CPPREADY_TRADER_GO_TRADEFLOW_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <ready_trader_go/types.h>
+
+#include "bookcache.h"
+
+// Decayed volumes carry this many fractional bits
+constexpr int FLOW_FRACTION_BITS = 16;
+
+// What has recently traded on one instrument. Volumes and notional decay
+// exponentially with each trade ticks message, so recent trades count the
+// most. Everything a reader needs is derived when a message arrives.
+struct FlowSnapshot {
+    // Lots bought from asks and sold into bids, with FLOW_FRACTION_BITS
+    // fractional bits
+    std::uint64_t buyVolume = 0;
+    std::uint64_t sellVolume = 0;
+    // Cents times lots; whole numbers are plenty and leave room to decay
+    // long histories without overflowing
+    std::uint64_t notional = 0;
+
+    // Volume-weighted average traded price, or zero before any trade
+    unsigned long vwap = 0;
+    // (buy volume - sell volume) / total, in IMBALANCE_SCALE units, so a
+    // positive value means buyers have been the aggressors
+    long imbalance = 0;
+};
+
+// Aggregates the trade ticks messages for both instruments in constant
+// memory, using only integer arithmetic once constructed.
+class TradeFlow {
+public:
+    // A trade's weight halves after this many further trade ticks messages
+    // for the same instrument.
+    explicit TradeFlow(unsigned long halfLife)
+        : mRetain(static_cast<std::uint64_t>(
+              std::lround(std::exp2(-1.0 / (halfLife == 0 ? 1 : halfLife)) *
+                          (1 << FLOW_FRACTION_BITS)))) {}
+
+    void Update(ReadyTraderGo::Instrument instrument,
+                const BookLevels &askPrices, const BookLevels &askVolumes,
+                const BookLevels &bidPrices, const BookLevels &bidVolumes) {
+        FlowSnapshot &flow = mFlows[static_cast<int>(instrument)];
+
+        std::uint64_t bought = 0;
+        std::uint64_t sold = 0;
+        std::uint64_t notional = 0;
+        for (int i = 0; i < ReadyTraderGo::TOP_LEVEL_COUNT; i++) {
+            bought += askVolumes[i];
+            sold += bidVolumes[i];
+            notional += askPrices[i] * askVolumes[i] +
+                        bidPrices[i] * bidVolumes[i];
+        }
+
+        flow.buyVolume = Decay(flow.buyVolume) + (bought << FLOW_FRACTION_BITS);
+        flow.sellVolume = Decay(flow.sellVolume) + (sold << FLOW_FRACTION_BITS);
+        flow.notional = Decay(flow.notional) + notional;
+
+        std::uint64_t total = flow.buyVolume + flow.sellVolume;
+        if (total == 0) {
+            flow.vwap = 0;
+            flow.imbalance = 0;
+            return;
+        }
+        flow.vwap = (flow.notional << FLOW_FRACTION_BITS) / total;
+        flow.imbalance = (static_cast<long>(flow.buyVolume) -
+                          static_cast<long>(flow.sellVolume)) *
+                         IMBALANCE_SCALE / static_cast<long>(total);
+    }
+
+    const FlowSnapshot &Etf() const {
+        return mFlows[static_cast<int>(ReadyTraderGo::Instrument::ETF)];
+    }
+    const FlowSnapshot &Future() const {
+        return mFlows[static_cast<int>(ReadyTraderGo::Instrument::FUTURE)];
+    }
+
+private:
+    std::uint64_t Decay(std::uint64_t value) const {
+        return (value * mRetain) >> FLOW_FRACTION_BITS;
+    }
+
+    // The weight kept per message, with FLOW_FRACTION_BITS fractional bits
+    std::uint64_t mRetain;
+
+    std::array<FlowSnapshot, 2> mFlows{};
+};
+
+#endif // CPPREADY_TRADER_GO_TRADEFLOW_H
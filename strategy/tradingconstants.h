@@ -0,0 +1,41 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_TRADINGCONSTANTS_H
+#define CPPREADY_TRADER_GO_TRADINGCONSTANTS_H
+
+#include <ready_trader_go/types.h>
+
+// Limits and price grid shared by every variant of the autotrader
+
+constexpr int POSITION_LIMIT = 100;
+constexpr int TICK_SIZE_IN_CENTS = 100;
+
+// The most aggressive prices a hedge can be sent at, used to make sure it
+// trades against whatever the future's book holds
+constexpr int MIN_BID_NEAREST_TICK =
+    (ReadyTraderGo::MINIMUM_BID + TICK_SIZE_IN_CENTS) / TICK_SIZE_IN_CENTS *
+    TICK_SIZE_IN_CENTS;
+constexpr int MAX_ASK_NEAREST_TICK =
+    ReadyTraderGo::MAXIMUM_ASK / TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
+
+// Messages kept back from the exchange's frequency limit to absorb clock
+// differences, and messages reserved for hedges and urgent cancels
+constexpr unsigned long RATE_SAFETY_MARGIN = 2;
+constexpr unsigned long RATE_CRITICAL_RESERVE = 8;
+
+#endif // CPPREADY_TRADER_GO_TRADINGCONSTANTS_H
@@ -0,0 +1,100 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE bookkernels_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <ready_trader_go/types.h>
+
+#include "bookkernels.h"
+
+using BookKernels::Levels;
+using ReadyTraderGo::TOP_LEVEL_COUNT;
+
+// This file is built once for each implementation the build machine can
+// run (see CMakeLists.txt), each time with the one it expects
+#ifndef RTG_EXPECTED_BOOK_KERNELS
+#error "RTG_EXPECTED_BOOK_KERNELS must name the implementation under test"
+#endif
+
+namespace {
+
+constexpr int ROUNDS = 100'000;
+
+unsigned long ReferenceTotalVolume(const Levels &volumes) {
+    unsigned long total = 0;
+    for (int i = 0; i < TOP_LEVEL_COUNT; i++) {
+        total += volumes[i];
+    }
+    return total;
+}
+
+unsigned long ReferenceNotional(const Levels &prices, const Levels &volumes) {
+    unsigned long total = 0;
+    for (int i = 0; i < TOP_LEVEL_COUNT; i++) {
+        total += prices[i] * volumes[i];
+    }
+    return total;
+}
+
+// A book side as the exchange sends it: anything that fits in 32 bits, with
+// the empty levels, if any, at the end
+void RandomSide(std::mt19937_64 &random, Levels &prices, Levels &volumes) {
+    std::uniform_int_distribution<int> levels(0, TOP_LEVEL_COUNT);
+    std::uniform_int_distribution<unsigned long> value(0, UINT32_MAX);
+    int populated = levels(random);
+    for (int i = 0; i < TOP_LEVEL_COUNT; i++) {
+        prices[i] = i < populated ? value(random) : 0;
+        volumes[i] = i < populated ? value(random) : 0;
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(the_expected_implementation_is_compiled_in) {
+    BOOST_CHECK_EQUAL(std::string(BookKernels::IMPLEMENTATION),
+                      RTG_EXPECTED_BOOK_KERNELS);
+}
+
+BOOST_AUTO_TEST_CASE(the_kernels_match_plain_loops) {
+    std::mt19937_64 random(20211);
+    Levels prices{}, volumes{};
+    for (int round = 0; round < ROUNDS; round++) {
+        RandomSide(random, prices, volumes);
+        BOOST_REQUIRE_EQUAL(BookKernels::TotalVolume(volumes),
+                            ReferenceTotalVolume(volumes));
+        BOOST_REQUIRE_EQUAL(BookKernels::Notional(prices, volumes),
+                            ReferenceNotional(prices, volumes));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_kernels_handle_empty_and_full_books) {
+    Levels zero{};
+    BOOST_CHECK_EQUAL(BookKernels::TotalVolume(zero), 0u);
+    BOOST_CHECK_EQUAL(BookKernels::Notional(zero, zero), 0u);
+
+    Levels largest;
+    largest.fill(UINT32_MAX);
+    BOOST_CHECK_EQUAL(BookKernels::TotalVolume(largest),
+                      ReferenceTotalVolume(largest));
+    BOOST_CHECK_EQUAL(BookKernels::Notional(largest, largest),
+                      ReferenceNotional(largest, largest));
+}
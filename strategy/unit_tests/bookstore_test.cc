@@ -0,0 +1,168 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE bookstore_test
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/error.h>
+
+#include "../common/bookstore.h"
+
+using ReadyTraderGo::ReadyTraderGoError;
+
+namespace {
+
+// Small enough that the fixture fills several blocks and part of another
+constexpr std::uint32_t BLOCK_RECORDS = 256;
+
+std::vector<BookRecord> LoadFixture(BookFileHeader &header) {
+    std::ifstream in("data/replay_fixture.bin", std::ios::binary);
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    std::vector<BookRecord> records;
+    BookRecord record{};
+    while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        records.push_back(record);
+    }
+    BOOST_REQUIRE(!records.empty());
+    return records;
+}
+
+std::string TemporaryStore(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void WriteStore(const std::string &filename, const BookFileHeader &header,
+                const std::vector<BookRecord> &records, bool compress) {
+    BookStoreWriter writer(filename, header, compress, BLOCK_RECORDS);
+    for (const BookRecord &record : records) {
+        writer.Append(record);
+    }
+    writer.Close();
+}
+
+bool SameRecord(const BookRecord &a, const BookRecord &b) {
+    return a.sequenceNumber == b.sequenceNumber &&
+           a.timestamp == b.timestamp && a.instrument == b.instrument &&
+           a.kind == b.kind &&
+           std::equal(std::begin(a.askPrices), std::end(a.askPrices),
+                      std::begin(b.askPrices)) &&
+           std::equal(std::begin(a.askVolumes), std::end(a.askVolumes),
+                      std::begin(b.askVolumes)) &&
+           std::equal(std::begin(a.bidPrices), std::end(a.bidPrices),
+                      std::begin(b.bidPrices)) &&
+           std::equal(std::begin(a.bidVolumes), std::end(a.bidVolumes),
+                      std::begin(b.bidVolumes));
+}
+
+void CheckRoundTrip(bool compress) {
+    BookFileHeader header{};
+    std::vector<BookRecord> records = LoadFixture(header);
+    std::string filename =
+        TemporaryStore(compress ? "bookstore_test.z.store"
+                                : "bookstore_test.store");
+    WriteStore(filename, header, records, compress);
+
+    BookStoreReader reader(filename);
+    BOOST_CHECK_EQUAL(reader.Compressed(), compress);
+    BOOST_CHECK_EQUAL(reader.Header().recordCount, records.size());
+    BOOST_CHECK_EQUAL(reader.BlockCount(),
+                      (records.size() + BLOCK_RECORDS - 1) / BLOCK_RECORDS);
+
+    std::vector<BookRecord> read;
+    reader.Read(read);
+    BOOST_REQUIRE_EQUAL(read.size(), records.size());
+    for (std::size_t i = 0; i < records.size(); i++) {
+        BOOST_REQUIRE_MESSAGE(SameRecord(read[i], records[i]),
+                              "record " << i << " differs");
+    }
+
+    // A window from the middle decodes only the records inside it
+    std::uint64_t from = records[records.size() / 3].timestamp;
+    std::uint64_t to = records[2 * records.size() / 3].timestamp;
+    read.clear();
+    reader.Read(read, from, to);
+    auto expected = std::count_if(
+        records.begin(), records.end(), [from, to](const BookRecord &r) {
+            return r.timestamp >= from && r.timestamp < to;
+        });
+    BOOST_CHECK_EQUAL(read.size(), static_cast<std::size_t>(expected));
+
+    std::filesystem::remove(filename);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(plain_store_round_trips) { CheckRoundTrip(false); }
+
+BOOST_AUTO_TEST_CASE(compressed_store_round_trips) { CheckRoundTrip(true); }
+
+BOOST_AUTO_TEST_CASE(rejects_a_record_count_its_block_cannot_hold) {
+    BookFileHeader header{};
+    std::vector<BookRecord> records = LoadFixture(header);
+    for (bool compress : {false, true}) {
+        std::string filename = TemporaryStore("bookstore_test.corrupt.store");
+        WriteStore(filename, header, records, compress);
+
+        BookStoreHeader storeHeader{};
+        std::fstream file(filename,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.read(reinterpret_cast<char *>(&storeHeader), sizeof(storeHeader));
+        std::uint32_t recordCount = 0x7fffffff;
+        file.seekp(storeHeader.indexOffset +
+                   offsetof(BookStoreIndexEntry, recordCount));
+        file.write(reinterpret_cast<const char *>(&recordCount),
+                   sizeof(recordCount));
+        file.close();
+
+        BOOST_CHECK_THROW(BookStoreReader reader(filename), ReadyTraderGoError);
+        std::filesystem::remove(filename);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(closing_reports_a_failed_write) {
+    if (!std::filesystem::exists("/dev/full")) {
+        return;
+    }
+    BookFileHeader header{};
+    std::vector<BookRecord> records = LoadFixture(header);
+    BookStoreWriter writer("/dev/full", header, false, BLOCK_RECORDS);
+    for (const BookRecord &record : records) {
+        writer.Append(record);
+    }
+    BOOST_CHECK_THROW(writer.Close(), ReadyTraderGoError);
+    // Once reported, the failure is not reported again
+    BOOST_CHECK_NO_THROW(writer.Close());
+}
+
+BOOST_AUTO_TEST_CASE(rejects_blocks_too_large_for_their_offsets) {
+    BookFileHeader header{};
+    LoadFixture(header);
+    std::string filename = TemporaryStore("bookstore_test.huge.store");
+    std::uint32_t blockRecords = BookStoreWriter::MAX_BLOCK_RECORDS + 1;
+    BOOST_CHECK_THROW(
+        BookStoreWriter writer(filename, header, true, blockRecords),
+        ReadyTraderGoError);
+    BOOST_CHECK(!std::filesystem::exists(filename));
+}
@@ -0,0 +1,187 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE etfarbitrage_test
+#include <boost/test/unit_test.hpp>
+
+#include <ready_trader_go/types.h>
+
+#include "bookcache.h"
+#include "etfarbitrage.h"
+#include "exchangelimits.h"
+
+using ReadyTraderGo::Instrument;
+using ReadyTraderGo::Side;
+
+namespace {
+
+// The competition's taker fee (2 basis points) and clamp (0.2%), so with
+// the default threshold of 1 basis point a take must make more than 3
+// basis points of the ETF's price, and the ETF is never taken more than
+// 0.2% from the future's mid
+const ExchangeLimits LIMITS;
+
+ArbitrageParameters Enabled(unsigned long volume = 10) {
+    ArbitrageParameters parameters;
+    parameters.enabled = true;
+    parameters.volume = volume;
+    return parameters;
+}
+
+// Both books, with the given touch and volumes at every level
+struct Books {
+    BookCache cache;
+    unsigned long sequenceNumber = 0;
+
+    void Set(Instrument instrument, unsigned long ask, unsigned long bid,
+             unsigned long volume = 50) {
+        BookLevels askPrices{}, bidPrices{}, volumes{};
+        askPrices.fill(ask);
+        bidPrices.fill(bid);
+        volumes.fill(volume);
+        cache.Update(instrument, ++sequenceNumber, askPrices, volumes,
+                     bidPrices, volumes);
+    }
+
+    ArbitrageTake Decide(const EtfArbitrage &arbitrage, long buyRoom = 100,
+                         long sellRoom = 100) const {
+        return arbitrage.Decide(cache.Etf(), cache.Future(), buyRoom,
+                                sellRoom);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(a_cheap_etf_is_bought_and_a_rich_one_sold) {
+    EtfArbitrage arbitrage(Enabled(), LIMITS);
+    Books books;
+    books.Set(Instrument::FUTURE, 10010, 10000);
+
+    books.Set(Instrument::ETF, 9990, 9980);
+    ArbitrageTake take = books.Decide(arbitrage);
+    BOOST_CHECK(take.side == Side::BUY);
+    BOOST_CHECK_EQUAL(take.price, 9990u);
+    BOOST_CHECK_EQUAL(take.volume, 10u);
+
+    books.Set(Instrument::ETF, 10030, 10020);
+    take = books.Decide(arbitrage);
+    BOOST_CHECK(take.side == Side::SELL);
+    BOOST_CHECK_EQUAL(take.price, 10020u);
+    BOOST_CHECK_EQUAL(take.volume, 10u);
+
+    // In line with the future, there is nothing to take
+    books.Set(Instrument::ETF, 10010, 10000);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(a_take_must_clear_the_fee_and_the_threshold) {
+    EtfArbitrage arbitrage(Enabled(), LIMITS);
+    Books books;
+    books.Set(Instrument::FUTURE, 10010, 10000);
+
+    // 3 cents is just over 3 basis points of $99.97...
+    books.Set(Instrument::ETF, 9997, 9987);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 10u);
+
+    // ...and 2 cents of $99.98 is not
+    books.Set(Instrument::ETF, 9998, 9988);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 0u);
+
+    // A higher threshold raises the hurdle
+    ArbitrageParameters parameters = Enabled();
+    parameters.thresholdBasis = 10;
+    EtfArbitrage demanding(parameters, LIMITS);
+    books.Set(Instrument::ETF, 9997, 9987);
+    BOOST_CHECK_EQUAL(books.Decide(demanding).volume, 0u);
+    books.Set(Instrument::ETF, 9985, 9975);
+    BOOST_CHECK_EQUAL(books.Decide(demanding).volume, 10u);
+}
+
+BOOST_AUTO_TEST_CASE(the_etf_is_never_taken_outside_the_clamp_band) {
+    EtfArbitrage arbitrage(Enabled(), LIMITS);
+    Books books;
+    books.Set(Instrument::FUTURE, 10010, 10000);
+
+    // The band is 0.2% of the future's mid of 100.05, about 20 cents
+    books.Set(Instrument::ETF, 9985, 9975);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 10u);
+    books.Set(Instrument::ETF, 9984, 9974);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 0u);
+
+    books.Set(Instrument::ETF, 10035, 10025);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 10u);
+    books.Set(Instrument::ETF, 10036, 10026);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(the_volume_is_the_least_of_both_books_the_limit_and_room) {
+    EtfArbitrage arbitrage(Enabled(), LIMITS);
+    Books books;
+    books.Set(Instrument::FUTURE, 10010, 10000, 50);
+    books.Set(Instrument::ETF, 9990, 9980, 7);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 7u);
+
+    books.Set(Instrument::FUTURE, 10010, 10000, 4);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 4u);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage, 3).volume, 3u);
+
+    // Only the room on the side being taken matters
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage, 3, 0).volume, 3u);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage, 0, 100).volume, 0u);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage, -5, 100).volume, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(nothing_is_taken_while_disabled_or_a_book_is_one_sided) {
+    Books books;
+    books.Set(Instrument::FUTURE, 10010, 10000);
+    books.Set(Instrument::ETF, 9990, 9980);
+
+    EtfArbitrage disabled(ArbitrageParameters(), LIMITS);
+    BOOST_CHECK(!disabled.Enabled());
+    BOOST_CHECK_EQUAL(books.Decide(disabled).volume, 0u);
+
+    EtfArbitrage noVolume(Enabled(0), LIMITS);
+    BOOST_CHECK(!noVolume.Enabled());
+    BOOST_CHECK_EQUAL(books.Decide(noVolume).volume, 0u);
+
+    EtfArbitrage arbitrage(Enabled(), LIMITS);
+    books.Set(Instrument::FUTURE, 10010, 0);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(the_usual_basis_is_learned_and_clamped) {
+    EtfArbitrage arbitrage(Enabled(), LIMITS);
+    Books books;
+    books.Set(Instrument::FUTURE, 10010, 10000);
+    BOOST_CHECK_EQUAL(arbitrage.Basis(), 0);
+
+    // An ETF 5 cents under the future's bid looks cheap at first, but not
+    // once it is known to sit 15 cents under the future's mid
+    books.Set(Instrument::ETF, 9995, 9985);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 10u);
+    for (int i = 0; i < 200; i++) {
+        arbitrage.UpdateBooks(books.cache);
+    }
+    BOOST_CHECK_EQUAL(arbitrage.Basis(), -15);
+    BOOST_CHECK_EQUAL(books.Decide(arbitrage).volume, 0u);
+
+    // A gap wider than the clamp is learned only as far as the clamp
+    EtfArbitrage clamped(Enabled(), LIMITS);
+    books.Set(Instrument::ETF, 9500, 9490);
+    clamped.UpdateBooks(books.cache);
+    BOOST_CHECK_EQUAL(clamped.Basis(), -20);
+}
@@ -0,0 +1,41 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE latencyprobes_test
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+#include "latencyprobes.h"
+
+// Calibrating the clock sleeps for 20 ms where the TSC is used; a tick that
+// did so would take far longer than this
+constexpr auto UNCALIBRATED_TICK = std::chrono::milliseconds(5);
+
+BOOST_AUTO_TEST_CASE(the_first_tick_does_not_calibrate_the_clock) {
+    // Nothing in this test has used the probes' clock before
+    LatencyProbes probes;
+
+    auto start = std::chrono::steady_clock::now();
+    probes.BeginTick();
+    probes.Decided();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK(elapsed < UNCALIBRATED_TICK);
+    BOOST_CHECK_EQUAL(
+        probes.Histogram(LatencyStage::TICK_TO_DECISION).Count(), 1u);
+}
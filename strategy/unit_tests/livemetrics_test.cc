@@ -0,0 +1,77 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE livemetrics_test
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "livemetrics.h"
+
+namespace {
+
+MetricsOptions LoadInterval(const std::string &interval) {
+    auto filename =
+        (std::filesystem::temp_directory_path() / "livemetrics_test.json")
+            .string();
+    std::ofstream(filename) << R"({"Metrics": {"File": "metrics.prom", )"
+                            << R"("Interval": )" << interval << "}}";
+    MetricsOptions options = LoadMetricsOptions(filename);
+    std::filesystem::remove(filename);
+    return options;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(reads_the_interval_in_seconds) {
+    MetricsOptions options = LoadInterval("2.5");
+    BOOST_CHECK_EQUAL(options.file, "metrics.prom");
+    BOOST_CHECK_EQUAL(options.interval, 2'500'000'000u);
+}
+
+BOOST_AUTO_TEST_CASE(a_failed_write_keeps_the_last_good_file) {
+    if (!std::filesystem::exists("/dev/full")) {
+        return;
+    }
+    auto directory = std::filesystem::temp_directory_path();
+    MetricsOptions options;
+    options.file = (directory / "livemetrics_test.prom").string();
+    std::ofstream(options.file) << "good\n";
+    // Every write to the temporary file fails
+    std::filesystem::remove(options.file + ".tmp");
+    std::filesystem::create_symlink("/dev/full", options.file + ".tmp");
+
+    LiveMetrics metrics;
+    MetricsExporter exporter;
+    exporter.Start(metrics, options);
+    exporter.Stop();
+
+    // Read no more than the good file holds, in case it was replaced
+    std::string contents(5, '\0');
+    std::ifstream(options.file).read(contents.data(), contents.size());
+    BOOST_CHECK_EQUAL(contents, "good\n");
+    std::filesystem::remove(options.file);
+    std::filesystem::remove(options.file + ".tmp");
+}
+
+BOOST_AUTO_TEST_CASE(raises_short_intervals_to_the_minimum) {
+    BOOST_CHECK_EQUAL(LoadInterval("0").interval, MIN_METRICS_INTERVAL);
+    BOOST_CHECK_EQUAL(LoadInterval("-1").interval, MIN_METRICS_INTERVAL);
+    BOOST_CHECK_EQUAL(LoadInterval("0.001").interval, MIN_METRICS_INTERVAL);
+}
@@ -0,0 +1,143 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE orderplanner_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+#include "orderplanner.h"
+
+using ReadyTraderGo::Side;
+
+namespace {
+
+// As many actions as the strategy plans at most
+constexpr std::size_t CAPACITY = 14;
+
+struct RecordingSink {
+    std::vector<OrderAction> actions;
+
+    void ExecuteOrderAction(const OrderAction &action) {
+        actions.push_back(action);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(emits_the_most_urgent_actions_first) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Cancel(Side::SELL, 1, 10100, 5, 100,
+                   OrderActionUrgency::EVICTION_CANCEL);
+    planner.Amend(Side::BUY, 2, 9900, 3);
+    planner.Insert(Side::SELL, 10200, 4);
+    planner.Cancel(Side::BUY, 3, 10000, 5, 100,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Cancel(Side::SELL, 4, 9800, 5, 300,
+                   OrderActionUrgency::STALE_CANCEL);
+
+    RecordingSink sink;
+    BOOST_CHECK_EQUAL(planner.Emit(sink), 5u);
+    BOOST_REQUIRE_EQUAL(sink.actions.size(), 5u);
+
+    // Stale cancels, furthest from the new quote first
+    BOOST_CHECK_EQUAL(sink.actions[0].clientOrderId, 4u);
+    BOOST_CHECK_EQUAL(sink.actions[1].clientOrderId, 3u);
+    // The eviction goes before the insert that takes its place
+    BOOST_CHECK_EQUAL(sink.actions[2].clientOrderId, 1u);
+    BOOST_CHECK(sink.actions[2].urgency ==
+                OrderActionUrgency::EVICTION_CANCEL);
+    BOOST_CHECK(sink.actions[3].type == OrderActionType::INSERT);
+    BOOST_CHECK_EQUAL(sink.actions[3].price, 10200u);
+    BOOST_CHECK(sink.actions[4].type == OrderActionType::AMEND);
+    BOOST_CHECK_EQUAL(sink.actions[4].volume, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(nets_a_cancel_and_an_insert_of_equal_volume) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Cancel(Side::BUY, 7, 10000, 5, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Insert(Side::BUY, 10000, 5);
+
+    RecordingSink sink;
+    BOOST_CHECK_EQUAL(planner.Emit(sink), 0u);
+    BOOST_CHECK(sink.actions.empty());
+}
+
+BOOST_AUTO_TEST_CASE(nets_a_smaller_insert_into_an_amend) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Insert(Side::SELL, 10100, 2);
+    planner.Cancel(Side::SELL, 7, 10100, 5, 0,
+                   OrderActionUrgency::EVICTION_CANCEL);
+
+    RecordingSink sink;
+    planner.Emit(sink);
+    BOOST_REQUIRE_EQUAL(sink.actions.size(), 1u);
+    BOOST_CHECK(sink.actions[0].type == OrderActionType::AMEND);
+    BOOST_CHECK_EQUAL(sink.actions[0].clientOrderId, 7u);
+    BOOST_CHECK_EQUAL(sink.actions[0].volume, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(nets_a_larger_insert_down_to_the_difference) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Cancel(Side::BUY, 7, 10000, 3, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Insert(Side::BUY, 10000, 5);
+
+    RecordingSink sink;
+    planner.Emit(sink);
+    BOOST_REQUIRE_EQUAL(sink.actions.size(), 1u);
+    BOOST_CHECK(sink.actions[0].type == OrderActionType::INSERT);
+    BOOST_CHECK_EQUAL(sink.actions[0].volume, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(nets_only_on_the_same_side_and_price) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Cancel(Side::BUY, 7, 10000, 5, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Cancel(Side::SELL, 8, 10100, 5, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Insert(Side::SELL, 10000, 5);
+    planner.Insert(Side::BUY, 9900, 5);
+
+    RecordingSink sink;
+    BOOST_CHECK_EQUAL(planner.Emit(sink), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(emitting_clears_the_plan) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Insert(Side::BUY, 10000, 5);
+    RecordingSink sink;
+    planner.Emit(sink);
+    BOOST_CHECK(planner.Empty());
+    BOOST_CHECK_EQUAL(planner.Emit(sink), 0u);
+    BOOST_CHECK_EQUAL(sink.actions.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(ignores_empty_inserts_and_overflow) {
+    OrderPlanner<CAPACITY> planner;
+    planner.Insert(Side::SELL, 10000, 0);
+    BOOST_CHECK(planner.Empty());
+
+    for (std::size_t i = 0; i <= CAPACITY; i++) {
+        planner.Insert(Side::SELL, 10000 + 100 * i, 1);
+    }
+    BOOST_CHECK_EQUAL(planner.Size(), CAPACITY);
+}
@@ -0,0 +1,99 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE rategovernor_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+
+#include "rategovernor.h"
+
+namespace {
+
+constexpr std::uint64_t INTERVAL = 1'000'000'000;
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(the_safety_margin_comes_off_the_limit) {
+    RateGovernor governor(50, INTERVAL, 5, 0);
+    BOOST_CHECK_EQUAL(governor.Capacity(), 45u);
+    BOOST_CHECK_EQUAL(governor.Remaining(0), 45u);
+
+    // A margin as large as the limit still leaves one message
+    RateGovernor tight(5, INTERVAL, 5, 0);
+    BOOST_CHECK_EQUAL(tight.Capacity(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(sends_leave_the_window_after_the_interval) {
+    RateGovernor governor(3, INTERVAL, 0, 0);
+    BOOST_CHECK(governor.TryAcquire(0));
+    BOOST_CHECK(governor.TryAcquire(10));
+    BOOST_CHECK(governor.TryAcquire(20));
+    BOOST_CHECK(!governor.TryAcquire(30));
+    BOOST_CHECK_EQUAL(governor.ThrottledCount(), 1u);
+
+    // Just inside the window of the first send, nothing has expired...
+    BOOST_CHECK_EQUAL(governor.Remaining(INTERVAL - 1), 0u);
+    BOOST_CHECK(!governor.TryAcquire(INTERVAL - 1));
+
+    // ...and each send frees its slot exactly one interval later
+    BOOST_CHECK_EQUAL(governor.Remaining(INTERVAL), 1u);
+    BOOST_CHECK(governor.TryAcquire(INTERVAL));
+    BOOST_CHECK(!governor.TryAcquire(INTERVAL + 9));
+    BOOST_CHECK_EQUAL(governor.Remaining(INTERVAL + 20), 2u);
+
+    // Once the window has passed, the whole budget is back
+    BOOST_CHECK_EQUAL(governor.Remaining(3 * INTERVAL), 3u);
+    BOOST_CHECK_EQUAL(governor.ThrottledCount(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(normal_messages_leave_the_reserve_untouched) {
+    RateGovernor governor(10, INTERVAL, 0, 3);
+    for (int i = 0; i < 7; i++) {
+        BOOST_CHECK(governor.TryAcquire(i, MessagePriority::NORMAL));
+    }
+    BOOST_CHECK_EQUAL(governor.Remaining(7, MessagePriority::NORMAL), 0u);
+    BOOST_CHECK_EQUAL(governor.Remaining(7, MessagePriority::CRITICAL), 3u);
+    BOOST_CHECK(!governor.TryAcquire(7, MessagePriority::NORMAL));
+    BOOST_CHECK_EQUAL(governor.ThrottledCount(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(critical_messages_pass_while_the_reserve_lasts) {
+    RateGovernor governor(10, INTERVAL, 0, 3);
+    for (int i = 0; i < 7; i++) {
+        BOOST_REQUIRE(governor.TryAcquire(i));
+    }
+    for (int i = 7; i < 10; i++) {
+        BOOST_CHECK(governor.TryAcquire(i, MessagePriority::CRITICAL));
+        BOOST_CHECK(!governor.TryAcquire(i, MessagePriority::NORMAL));
+    }
+    BOOST_CHECK(!governor.TryAcquire(10, MessagePriority::CRITICAL));
+    BOOST_CHECK_EQUAL(governor.ThrottledCount(), 4u);
+
+    // The reserve refills as the window moves on, and normal messages can
+    // use the budget again once it is full
+    BOOST_CHECK_EQUAL(governor.Remaining(INTERVAL + 2), 0u);
+    BOOST_CHECK_EQUAL(
+        governor.Remaining(INTERVAL + 2, MessagePriority::CRITICAL), 3u);
+    BOOST_CHECK_EQUAL(governor.Remaining(INTERVAL + 3), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(the_reserve_never_takes_the_whole_budget) {
+    RateGovernor governor(4, INTERVAL, 0, 10);
+    BOOST_CHECK_EQUAL(governor.Remaining(0, MessagePriority::NORMAL), 1u);
+    BOOST_CHECK_EQUAL(governor.Remaining(0, MessagePriority::CRITICAL), 4u);
+}
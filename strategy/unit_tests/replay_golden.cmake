@@ -0,0 +1,20 @@
+# Replays RECORDING with REPLAY and compares the summary with EXPECTED.
+# The timings vary from run to run, so those lines are left out.
+#
+#     cmake -DREPLAY=... -DRECORDING=... -DLIMITS=... -DEXPECTED=...
+#           [-DARGS=...] -P replay_golden.cmake
+execute_process(COMMAND ${REPLAY} ${ARGS} ${RECORDING} ${LIMITS}
+        OUTPUT_VARIABLE output RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "replay failed (${result}):\n${output}")
+endif()
+
+string(REGEX REPLACE "time: [^\n]*\n" "" output "${output}")
+string(REGEX REPLACE "[a-z_]+: count [^\n]*\n" "" output "${output}")
+
+file(READ ${EXPECTED} expected)
+if(NOT output STREQUAL expected)
+    message(FATAL_ERROR
+            "replay summary differs from ${EXPECTED}\n"
+            "expected:\n${expected}\nactual:\n${output}")
+endif()
@@ -0,0 +1,67 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE replayexchange_test
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "exchangelimits.h"
+#include "replayexchange.h"
+#include "strategy.h"
+
+namespace {
+
+struct ReplayFees {
+    long maker;
+    long taker;
+};
+
+// Replays the fixture against an exchange charging the given fees and
+// returns the fees the strategy's accounting saw
+ReplayFees Replay(double makerFee, double takerFee) {
+    BookFileHeader header{};
+    std::vector<BookRecord> records =
+        LoadRecording("data/replay_fixture.bin", header);
+    BOOST_REQUIRE(!records.empty());
+
+    ExchangeLimits limits;
+    limits.makerFee = makerFee;
+    limits.takerFee = takerFee;
+    ReplayExchange exchange(limits);
+    Strategy strategy(exchange, limits);
+    exchange.Attach(strategy);
+    for (const BookRecord &record : records) {
+        exchange.Replay(record);
+    }
+    BOOST_REQUIRE_NE(exchange.Stats().fills, 0u);
+    return {strategy.Accounts().MakerFees(), strategy.Accounts().TakerFees()};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fills_are_charged_the_configured_fees) {
+    ReplayFees free = Replay(0, 0);
+    BOOST_CHECK_EQUAL(free.maker, 0);
+    BOOST_CHECK_EQUAL(free.taker, 0);
+
+    ExchangeLimits defaults;
+    ReplayFees charged = Replay(defaults.makerFee, defaults.takerFee);
+    BOOST_CHECK_NE(charged.maker + charged.taker, 0);
+    BOOST_CHECK_LE(charged.maker, 0);
+    BOOST_CHECK_GE(charged.taker, 0);
+}
@@ -0,0 +1,126 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE sizingcurve_test
+#include <boost/test/unit_test.hpp>
+
+#include "price.h"
+#include "sizingcurve.h"
+#include "tradingconstants.h"
+
+namespace {
+
+SizingCurveParameters Curvature(double curvature, long divisor = 5) {
+    SizingCurveParameters parameters;
+    parameters.divisor = divisor;
+    parameters.curvature = curvature;
+    return parameters;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(the_default_curve_is_the_old_sizing) {
+    SizingCurve curve{SizingCurveParameters()};
+    for (long position = -POSITION_LIMIT; position <= POSITION_LIMIT;
+         position++) {
+        BOOST_CHECK_EQUAL(curve.AskVolume(position),
+                          (position + POSITION_LIMIT) / 5);
+        BOOST_CHECK_EQUAL(curve.BidVolume(position),
+                          (POSITION_LIMIT - position) / 5);
+        BOOST_CHECK_EQUAL(curve.SkewBasis(position), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(every_curvature_meets_the_line_at_its_ends) {
+    for (double curvature : {-1.0, -0.5, 0.0, 0.5, 1.0}) {
+        SizingCurve curve(Curvature(curvature));
+        // No room, no order; all the room, the plain division
+        BOOST_CHECK_EQUAL(curve.BidVolume(POSITION_LIMIT), 0);
+        BOOST_CHECK_EQUAL(curve.AskVolume(-POSITION_LIMIT), 0);
+        BOOST_CHECK_EQUAL(curve.BidVolume(-POSITION_LIMIT),
+                          2 * POSITION_LIMIT / 5);
+        BOOST_CHECK_EQUAL(curve.AskVolume(POSITION_LIMIT),
+                          2 * POSITION_LIMIT / 5);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(curvature_bends_the_line_between_its_ends) {
+    // Flat, half the room is half the volume; at 1 it is a quarter and at
+    // -1 three quarters
+    BOOST_CHECK_EQUAL(SizingCurve(Curvature(0.0)).BidVolume(0), 20);
+    BOOST_CHECK_EQUAL(SizingCurve(Curvature(1.0)).BidVolume(0), 10);
+    BOOST_CHECK_EQUAL(SizingCurve(Curvature(-1.0)).BidVolume(0), 30);
+
+    // Out of range curvatures are clamped
+    BOOST_CHECK_EQUAL(SizingCurve(Curvature(3.0)).BidVolume(0), 10);
+    BOOST_CHECK_EQUAL(SizingCurve(Curvature(-3.0)).BidVolume(0), 30);
+
+    // The volume never grows as the room shrinks
+    for (double curvature : {-1.0, 0.0, 1.0}) {
+        SizingCurve curve(Curvature(curvature));
+        for (long position = -POSITION_LIMIT; position < POSITION_LIMIT;
+             position++) {
+            BOOST_CHECK_GE(curve.BidVolume(position),
+                           curve.BidVolume(position + 1));
+            BOOST_CHECK_LE(curve.AskVolume(position),
+                           curve.AskVolume(position + 1));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_skew_leans_against_the_position) {
+    SizingCurveParameters parameters;
+    parameters.skewBasis = 20;
+    SizingCurve linear(parameters);
+    BOOST_CHECK_EQUAL(linear.SkewBasis(0), 0);
+    BOOST_CHECK_EQUAL(linear.SkewBasis(POSITION_LIMIT), -20);
+    BOOST_CHECK_EQUAL(linear.SkewBasis(-POSITION_LIMIT), 20);
+    BOOST_CHECK_EQUAL(linear.SkewBasis(POSITION_LIMIT / 2), -10);
+
+    parameters.skewCurvature = 1.0;
+    SizingCurve quadratic(parameters);
+    BOOST_CHECK_EQUAL(quadratic.SkewBasis(POSITION_LIMIT), -20);
+    BOOST_CHECK_EQUAL(quadratic.SkewBasis(POSITION_LIMIT / 2), -5);
+    BOOST_CHECK_EQUAL(quadratic.SkewBasis(-POSITION_LIMIT / 2), 5);
+
+    // Beyond the limit, the table's ends are used
+    BOOST_CHECK_EQUAL(quadratic.SkewBasis(3 * POSITION_LIMIT), -20);
+}
+
+BOOST_AUTO_TEST_CASE(no_order_is_for_more_than_the_room_left) {
+    for (double curvature : {-1.0, -0.5, 0.0}) {
+        SizingCurve curve(Curvature(curvature, 1));
+        for (long position = -POSITION_LIMIT; position <= POSITION_LIMIT;
+             position++) {
+            BOOST_CHECK_LE(curve.AskVolume(position),
+                           position + POSITION_LIMIT);
+            BOOST_CHECK_LE(curve.BidVolume(position),
+                           POSITION_LIMIT - position);
+        }
+    }
+    // Half the room, scaled up by half, is capped at the room
+    BOOST_CHECK_EQUAL(SizingCurve(Curvature(-1.0, 1)).BidVolume(0),
+                      POSITION_LIMIT);
+}
+
+BOOST_AUTO_TEST_CASE(the_skew_never_leans_a_whole_price) {
+    SizingCurveParameters parameters;
+    parameters.skewBasis = 3 * BASIS_POINTS;
+    SizingCurve curve(parameters);
+    BOOST_CHECK_EQUAL(curve.SkewBasis(POSITION_LIMIT), MIN_BASIS);
+    BOOST_CHECK_EQUAL(curve.SkewBasis(-POSITION_LIMIT), -MIN_BASIS);
+}
@@ -0,0 +1,413 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE strategy_test
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/error.h>
+#include <ready_trader_go/types.h>
+
+#include "exchangelimits.h"
+#include "executiongateway.h"
+#include "strategy.h"
+
+using ReadyTraderGo::Instrument;
+using ReadyTraderGo::Lifespan;
+using ReadyTraderGo::Side;
+using ReadyTraderGo::TOP_LEVEL_COUNT;
+
+namespace {
+
+struct SentOrder {
+    unsigned long clientOrderId;
+    Side side;
+    unsigned long price;
+    unsigned long volume;
+    Lifespan lifespan;
+};
+
+// Keeps everything the strategy sends, for the test to answer as the
+// exchange would.
+class RecordingGateway : public ExecutionGateway {
+public:
+    std::vector<SentOrder> inserts;
+    std::vector<SentOrder> hedges;
+    std::vector<unsigned long> cancels;
+    std::uint64_t now = 1;
+
+    void SendAmendOrder(unsigned long, unsigned long) override {}
+    void SendCancelOrder(unsigned long clientOrderId) override {
+        cancels.push_back(clientOrderId);
+    }
+    void SendHedgeOrder(unsigned long clientOrderId, Side side,
+                        unsigned long price, unsigned long volume) override {
+        hedges.push_back(
+            {clientOrderId, side, price, volume, Lifespan::FILL_AND_KILL});
+    }
+    void SendInsertOrder(unsigned long clientOrderId, Side side,
+                         unsigned long price, unsigned long volume,
+                         Lifespan lifespan) override {
+        inserts.push_back({clientOrderId, side, price, volume, lifespan});
+    }
+
+    std::uint64_t Now() const override { return now; }
+};
+
+using Levels = std::array<unsigned long, TOP_LEVEL_COUNT>;
+
+// Gives both instruments the same book around $100, so the strategy
+// quotes the ETF and finds nothing to take.
+void SendBooks(Strategy &strategy, unsigned long sequenceNumber = 1) {
+    Levels askPrices{}, bidPrices{}, volumes{};
+    for (int level = 0; level < TOP_LEVEL_COUNT; level++) {
+        askPrices[level] = 10100 + 100 * level;
+        bidPrices[level] = 9900 - 100 * level;
+        volumes[level] = 50;
+    }
+    strategy.OrderBookMessageHandler(Instrument::ETF, sequenceNumber,
+                                     askPrices, volumes, bidPrices, volumes);
+    strategy.OrderBookMessageHandler(Instrument::FUTURE, sequenceNumber,
+                                     askPrices, volumes, bidPrices, volumes);
+}
+
+// Leaves the ETF's ask well under the future's bid, and inside the band
+// the exchange keeps it in, for the arbitrage to take.
+void SendDislocatedBooks(Strategy &strategy) {
+    Levels futureAsks{}, futureBids{}, etfAsks{}, etfBids{}, volumes{};
+    for (int level = 0; level < TOP_LEVEL_COUNT; level++) {
+        futureAsks[level] = 10001 + 100 * level;
+        futureBids[level] = 9999 - 100 * level;
+        etfAsks[level] = 9990 + 100 * level;
+        etfBids[level] = 9970 - 100 * level;
+        volumes[level] = 50;
+    }
+    strategy.OrderBookMessageHandler(Instrument::FUTURE, 2, futureAsks,
+                                     volumes, futureBids, volumes);
+    strategy.OrderBookMessageHandler(Instrument::ETF, 2, etfAsks, volumes,
+                                     etfBids, volumes);
+}
+
+// Loads limits from the given exchange configuration
+ExchangeLimits LoadExchange(const std::string &config) {
+    auto filename =
+        (std::filesystem::temp_directory_path() / "strategy_test.json")
+            .string();
+    std::ofstream(filename) << config;
+    ExchangeLimits limits = LoadExchangeLimits(filename);
+    std::filesystem::remove(filename);
+    return limits;
+}
+
+// Messages the strategy could still send at the gateway's time
+unsigned long Budget(const Strategy &strategy) {
+    RateGovernor governor = strategy.Governor();
+    return governor.Remaining(1);
+}
+
+const SentOrder &FirstInsert(const RecordingGateway &gateway, Side side) {
+    for (const SentOrder &order : gateway.inserts) {
+        if (order.side == side) {
+            return order;
+        }
+    }
+    BOOST_FAIL("no order was inserted on that side");
+    return gateway.inserts.front();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(an_error_on_a_partly_filled_order_keeps_its_fills) {
+    RecordingGateway gateway;
+    Strategy strategy(gateway, ExchangeLimits{});
+    SendBooks(strategy);
+    SentOrder bid = FirstInsert(gateway, Side::BUY);
+    BOOST_REQUIRE_GT(bid.volume, 3u);
+
+    strategy.OrderStatusMessageHandler(bid.clientOrderId, 3, bid.volume - 3,
+                                       -2);
+    BOOST_REQUIRE_EQUAL(strategy.EtfPosition(), 3);
+    long unhedged = strategy.Hedges().Unhedged();
+    long fees = strategy.Accounts().Fees();
+    auto hedgeCount = gateway.hedges.size();
+    auto exposure = strategy.Metrics().Get(Metric::ETF_BUY_EXPOSURE);
+    auto bidOrders = strategy.Metrics().Get(Metric::BID_ORDERS);
+
+    strategy.ErrorMessageHandler(bid.clientOrderId, "rejected");
+
+    BOOST_CHECK_EQUAL(strategy.EtfPosition(), 3);
+    BOOST_CHECK_EQUAL(strategy.Hedges().Unhedged(), unhedged);
+    BOOST_CHECK_EQUAL(strategy.Accounts().Fees(), fees);
+    BOOST_CHECK_EQUAL(gateway.hedges.size(), hedgeCount);
+    BOOST_CHECK_EQUAL(strategy.Metrics().Get(Metric::ETF_BUY_EXPOSURE),
+                      exposure - (long)(bid.volume - 3));
+    BOOST_CHECK_EQUAL(strategy.Metrics().Get(Metric::BID_ORDERS),
+                      bidOrders - 1);
+
+    // The exchange no longer knows the order, nor do we
+    strategy.OrderStatusMessageHandler(bid.clientOrderId, 0, 0, 0);
+    BOOST_CHECK_EQUAL(strategy.EtfPosition(), 3);
+    BOOST_CHECK_EQUAL(strategy.Accounts().Fees(), fees);
+}
+
+BOOST_AUTO_TEST_CASE(an_error_for_an_unknown_order_changes_nothing) {
+    RecordingGateway gateway;
+    Strategy strategy(gateway, ExchangeLimits{});
+    SendBooks(strategy);
+    auto exposure = strategy.Metrics().Get(Metric::ETF_SELL_EXPOSURE);
+
+    strategy.ErrorMessageHandler(0, "bad message");
+    strategy.ErrorMessageHandler(999, "no such order");
+
+    BOOST_CHECK_EQUAL(strategy.EtfPosition(), 0);
+    BOOST_CHECK_EQUAL(strategy.Metrics().Get(Metric::ETF_SELL_EXPOSURE),
+                      exposure);
+    BOOST_CHECK(gateway.hedges.empty());
+}
+
+BOOST_AUTO_TEST_CASE(an_error_on_a_partly_filled_take_keeps_its_fees) {
+    RecordingGateway gateway;
+    StrategyParameters parameters;
+    parameters.arbitrage.enabled = true;
+    Strategy strategy(gateway, ExchangeLimits{}, parameters);
+    SendBooks(strategy);
+    SendDislocatedBooks(strategy);
+
+    const SentOrder *found = nullptr;
+    for (const SentOrder &order : gateway.inserts) {
+        if (order.lifespan == Lifespan::FILL_AND_KILL) {
+            found = &order;
+        }
+    }
+    BOOST_REQUIRE(found != nullptr);
+    SentOrder take = *found;
+    BOOST_REQUIRE(take.side == Side::BUY);
+    BOOST_REQUIRE_GT(take.volume, 4u);
+
+    strategy.OrderStatusMessageHandler(take.clientOrderId, 4, take.volume - 4,
+                                       8);
+    long position = strategy.EtfPosition();
+    long unhedged = strategy.Hedges().Unhedged();
+    long fees = strategy.Accounts().Fees();
+    auto hedgeCount = gateway.hedges.size();
+    auto exposure = strategy.Metrics().Get(Metric::ETF_BUY_EXPOSURE);
+    BOOST_REQUIRE_EQUAL(fees, 8);
+
+    strategy.ErrorMessageHandler(take.clientOrderId, "rejected");
+
+    BOOST_CHECK_EQUAL(strategy.EtfPosition(), position);
+    BOOST_CHECK_EQUAL(strategy.Hedges().Unhedged(), unhedged);
+    BOOST_CHECK_EQUAL(strategy.Accounts().Fees(), fees);
+    BOOST_CHECK_EQUAL(gateway.hedges.size(), hedgeCount);
+    BOOST_CHECK_EQUAL(strategy.Metrics().Get(Metric::ETF_BUY_EXPOSURE),
+                      exposure - (long)(take.volume - 4));
+}
+
+BOOST_AUTO_TEST_CASE(actions_that_change_nothing_spend_no_message_budget) {
+    RecordingGateway gateway;
+    Strategy strategy(gateway, ExchangeLimits{});
+    SendBooks(strategy);
+    SentOrder bid = FirstInsert(gateway, Side::BUY);
+    unsigned long remaining = Budget(strategy);
+
+    // The planner is the strategy's way of sending actions
+    OrderPlanner<MAX_PLANNED_ACTIONS> planner;
+    planner.Amend(Side::BUY, bid.clientOrderId, bid.price, bid.volume);
+    planner.Cancel(Side::BUY, 999, bid.price, 1, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Emit(strategy);
+    BOOST_CHECK_EQUAL(Budget(strategy), remaining);
+
+    planner.Cancel(Side::BUY, bid.clientOrderId, bid.price, bid.volume, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Emit(strategy);
+    BOOST_CHECK_EQUAL(Budget(strategy), remaining - 1);
+
+    // Already cancelling
+    planner.Cancel(Side::BUY, bid.clientOrderId, bid.price, bid.volume, 0,
+                   OrderActionUrgency::STALE_CANCEL);
+    planner.Emit(strategy);
+    BOOST_CHECK_EQUAL(Budget(strategy), remaining - 1);
+}
+
+BOOST_AUTO_TEST_CASE(quoting_stops_while_no_hedge_can_be_sent) {
+    RecordingGateway gateway;
+    StrategyParameters parameters;
+    parameters.hedgeThreshold = 1;
+    Strategy strategy(gateway, ExchangeLimits{}, parameters);
+    SendBooks(strategy);
+    SentOrder bid = FirstInsert(gateway, Side::BUY);
+    BOOST_REQUIRE_GT(bid.volume, (unsigned long)MAX_OUTSTANDING_HEDGES);
+
+    // Each lot is hedged at once, until every hedge slot is waiting on a
+    // fill
+    unsigned long filled = 0;
+    for (; filled < (unsigned long)MAX_OUTSTANDING_HEDGES; filled++) {
+        strategy.OrderStatusMessageHandler(bid.clientOrderId, filled + 1,
+                                           bid.volume - filled - 1, 0);
+    }
+    BOOST_REQUIRE_EQUAL(gateway.hedges.size(),
+                        (std::size_t)MAX_OUTSTANDING_HEDGES);
+    BOOST_REQUIRE(gateway.cancels.empty());
+
+    // The next lot cannot be hedged, so every order is pulled
+    filled++;
+    strategy.OrderStatusMessageHandler(bid.clientOrderId, filled,
+                                       bid.volume - filled, 0);
+    BOOST_CHECK_EQUAL(gateway.hedges.size(),
+                      (std::size_t)MAX_OUTSTANDING_HEDGES);
+    BOOST_CHECK_EQUAL(strategy.Hedges().Unhedged(), -1);
+    BOOST_CHECK_EQUAL(gateway.cancels.size(), gateway.inserts.size());
+
+    // Nothing is quoted, or taken, until a hedge is answered
+    for (unsigned long cancel : gateway.cancels) {
+        strategy.OrderStatusMessageHandler(cancel, 0, 0, 0);
+    }
+    auto inserts = gateway.inserts.size();
+    SendBooks(strategy, 2);
+    BOOST_CHECK_EQUAL(gateway.inserts.size(), inserts);
+
+    strategy.HedgeFilledMessageHandler(gateway.hedges.front().clientOrderId,
+                                       10000, 1);
+    BOOST_CHECK_EQUAL(gateway.hedges.size(),
+                      (std::size_t)MAX_OUTSTANDING_HEDGES + 1);
+    BOOST_CHECK_EQUAL(strategy.Hedges().Unhedged(), 0);
+    SendBooks(strategy, 3);
+    BOOST_CHECK_GT(gateway.inserts.size(), inserts);
+}
+
+BOOST_AUTO_TEST_CASE(an_extreme_skew_does_not_wrap_the_quotes) {
+    RecordingGateway gateway;
+    StrategyParameters parameters;
+    parameters.flowSkewBasis = 3 * BASIS_POINTS;
+    Strategy strategy(gateway, ExchangeLimits{}, parameters);
+
+    // Only sellers have traded, so both quotes lean down by three prices
+    Levels prices{}, volumes{}, none{};
+    prices[0] = 9900;
+    volumes[0] = 10;
+    strategy.TradeTicksMessageHandler(Instrument::ETF, 1, none, none, prices,
+                                      volumes);
+    BOOST_REQUIRE_LT(strategy.Flow().Etf().imbalance, 0);
+    SendBooks(strategy);
+
+    BOOST_REQUIRE(!gateway.inserts.empty());
+    for (const SentOrder &order : gateway.inserts) {
+        BOOST_CHECK_LE(order.price, 10100u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(a_hedge_goes_out_when_its_window_closes) {
+    RecordingGateway gateway;
+    StrategyParameters parameters;
+    Strategy strategy(gateway, ExchangeLimits{}, parameters);
+    SendBooks(strategy);
+    SentOrder bid = FirstInsert(gateway, Side::BUY);
+    BOOST_REQUIRE_GT(bid.volume, 2u);
+    BOOST_CHECK_EQUAL(strategy.HedgeWindowEnd(), 0u);
+
+    // A small fill opens the window, and is held back for it
+    strategy.OrderStatusMessageHandler(bid.clientOrderId, 2, bid.volume - 2,
+                                       0);
+    BOOST_REQUIRE(gateway.hedges.empty());
+    BOOST_CHECK_EQUAL(strategy.HedgeWindowEnd(),
+                      gateway.now + parameters.hedgeWindow);
+
+    gateway.now += parameters.hedgeWindow - 1;
+    strategy.FlushHedges();
+    BOOST_CHECK(gateway.hedges.empty());
+
+    // With no event to wait for, the adapter's timer flushes it
+    gateway.now += 1;
+    strategy.FlushHedges();
+    BOOST_REQUIRE_EQUAL(gateway.hedges.size(), 1u);
+    BOOST_CHECK(gateway.hedges.front().side == Side::SELL);
+    BOOST_CHECK_EQUAL(gateway.hedges.front().volume, 2u);
+    BOOST_CHECK_EQUAL(strategy.HedgeWindowEnd(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(a_silent_feed_pulls_our_orders) {
+    RecordingGateway gateway;
+    ExchangeLimits limits;
+    StrategyParameters parameters;
+    Strategy strategy(gateway, limits, parameters);
+    SendBooks(strategy);
+    BOOST_REQUIRE(!gateway.inserts.empty());
+
+    // No message arrives, but the feed is still checked every tick
+    for (unsigned long tick = 1; tick < parameters.staleTicks; tick++) {
+        gateway.now += limits.tickInterval;
+        strategy.CheckFeed();
+    }
+    BOOST_CHECK(gateway.cancels.empty());
+
+    gateway.now += limits.tickInterval;
+    strategy.CheckFeed();
+    BOOST_CHECK_EQUAL(gateway.cancels.size(), gateway.inserts.size());
+
+    // Once pulled, checking again sends nothing more
+    strategy.CheckFeed();
+    BOOST_CHECK_EQUAL(gateway.cancels.size(), gateway.inserts.size());
+}
+
+BOOST_AUTO_TEST_CASE(writing_accounting_samples_reports_a_failed_write) {
+    if (!std::filesystem::exists("/dev/full")) {
+        return;
+    }
+    RecordingGateway gateway;
+    Strategy strategy(gateway, ExchangeLimits{});
+    SendBooks(strategy);
+    BOOST_CHECK_THROW(WriteAccountingSamples("/dev/full", strategy.Accounts()),
+                      ReadyTraderGo::ReadyTraderGoError);
+}
+
+BOOST_AUTO_TEST_CASE(the_tick_interval_is_in_real_time) {
+    BOOST_CHECK_EQUAL(
+        LoadExchange(R"({"Engine": {"TickInterval": 0.25}})").tickInterval,
+        250'000'000u);
+    BOOST_CHECK_EQUAL(
+        LoadExchange(R"({"Engine": {"TickInterval": 0.25, "Speed": 2.0}})")
+            .tickInterval,
+        125'000'000u);
+    BOOST_CHECK_EQUAL(
+        LoadExchange(R"({"Engine": {"TickInterval": 0.25, "Speed": 0}})")
+            .tickInterval,
+        250'000'000u);
+
+    // The message limit's window shrinks with the engine's speed too
+    BOOST_CHECK_EQUAL(
+        LoadExchange(R"({"Limits": {"MessageFrequencyInterval": 1.0}})")
+            .messageFrequencyInterval,
+        1'000'000'000u);
+    BOOST_CHECK_EQUAL(
+        LoadExchange(R"({"Limits": {"MessageFrequencyInterval": 1.0},
+                         "Engine": {"Speed": 2.0}})")
+            .messageFrequencyInterval,
+        500'000'000u);
+    BOOST_CHECK_EQUAL(
+        LoadExchange(R"({"Limits": {"MessageFrequencyInterval": 1.0},
+                         "Engine": {"Speed": -1}})")
+            .messageFrequencyInterval,
+        1'000'000'000u);
+}
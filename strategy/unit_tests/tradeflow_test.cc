@@ -0,0 +1,100 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#define BOOST_TEST_MODULE tradeflow_test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+
+#include <ready_trader_go/types.h>
+
+#include "bookcache.h"
+#include "tradeflow.h"
+
+using ReadyTraderGo::Instrument;
+
+namespace {
+
+// One trade ticks message: buyers took volume at askPrice and sellers hit
+// bidPrice for bidVolume
+void Trade(TradeFlow &flow, Instrument instrument, unsigned long askPrice,
+           unsigned long askVolume, unsigned long bidPrice,
+           unsigned long bidVolume) {
+    BookLevels askPrices{}, askVolumes{}, bidPrices{}, bidVolumes{};
+    askPrices[0] = askPrice;
+    askVolumes[0] = askVolume;
+    bidPrices[0] = bidPrice;
+    bidVolumes[0] = bidVolume;
+    flow.Update(instrument, askPrices, askVolumes, bidPrices, bidVolumes);
+}
+
+double Lots(std::uint64_t volume) {
+    return double(volume) / (1 << FLOW_FRACTION_BITS);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(a_trade_weighs_half_as_much_after_a_half_life) {
+    constexpr unsigned long HALF_LIFE = 8;
+    TradeFlow flow(HALF_LIFE);
+    Trade(flow, Instrument::ETF, 10000, 1000, 0, 0);
+    BOOST_CHECK_CLOSE(Lots(flow.Etf().buyVolume), 1000.0, 0.001);
+
+    for (unsigned long i = 0; i < HALF_LIFE; i++) {
+        Trade(flow, Instrument::ETF, 0, 0, 0, 0);
+    }
+    BOOST_CHECK_CLOSE(Lots(flow.Etf().buyVolume), 500.0, 0.1);
+
+    for (unsigned long i = 0; i < HALF_LIFE; i++) {
+        Trade(flow, Instrument::ETF, 0, 0, 0, 0);
+    }
+    BOOST_CHECK_CLOSE(Lots(flow.Etf().buyVolume), 250.0, 0.1);
+
+    // Messages for the other instrument do not age this one's trades
+    for (unsigned long i = 0; i < 10 * HALF_LIFE; i++) {
+        Trade(flow, Instrument::FUTURE, 0, 0, 0, 0);
+    }
+    BOOST_CHECK_CLOSE(Lots(flow.Etf().buyVolume), 250.0, 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(the_imbalance_leans_towards_the_aggressors) {
+    TradeFlow buyers(8);
+    Trade(buyers, Instrument::ETF, 10000, 30, 9900, 10);
+    BOOST_CHECK_EQUAL(buyers.Etf().imbalance, IMBALANCE_SCALE / 2);
+
+    TradeFlow sellers(8);
+    Trade(sellers, Instrument::ETF, 10000, 10, 9900, 30);
+    BOOST_CHECK_EQUAL(sellers.Etf().imbalance, -IMBALANCE_SCALE / 2);
+
+    TradeFlow onlyBuyers(8);
+    Trade(onlyBuyers, Instrument::ETF, 10000, 5, 0, 0);
+    BOOST_CHECK_EQUAL(onlyBuyers.Etf().imbalance, IMBALANCE_SCALE);
+
+    // Older selling is outweighed by a later buy of the same size
+    TradeFlow turning(8);
+    Trade(turning, Instrument::ETF, 0, 0, 9900, 20);
+    Trade(turning, Instrument::ETF, 10000, 20, 0, 0);
+    BOOST_CHECK_GT(turning.Etf().imbalance, 0);
+    BOOST_CHECK_EQUAL(turning.Future().imbalance, 0);
+}
+
+BOOST_AUTO_TEST_CASE(the_vwap_weighs_prices_by_volume) {
+    TradeFlow flow(8);
+    BOOST_CHECK_EQUAL(flow.Etf().vwap, 0u);
+    Trade(flow, Instrument::ETF, 10100, 30, 9900, 10);
+    BOOST_CHECK_EQUAL(flow.Etf().vwap, 10050u);
+}
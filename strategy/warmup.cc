@@ -0,0 +1,105 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include "warmup.h"
+
+using namespace ReadyTraderGo;
+
+// The books are centred on this price, in cents, and move by whole ticks
+constexpr unsigned long START_PRICE = 10000;
+constexpr unsigned long TICK_SIZE = 100;
+
+// How far the clock moves on between updates, in nanoseconds
+constexpr std::uint64_t UPDATE_INTERVAL = 250'000'000;
+
+// One insert in this many is filled for a lot
+constexpr unsigned long FILL_EVERY = 3;
+
+WarmUpExchange::WarmUpExchange() : mNow(UPDATE_INTERVAL) {
+    mCallbacks.reserve(256);
+}
+
+void WarmUpExchange::MakeBook(unsigned long update) {
+    mNow += UPDATE_INTERVAL;
+
+    // Up four ticks and back down again, one tick every four updates
+    unsigned long step = (update / 4) % 8;
+    mMid = START_PRICE + TICK_SIZE * (step < 4 ? step : 8 - step);
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT; i++) {
+        mAskPrices[i] = mMid + TICK_SIZE * (i + 1);
+        mBidPrices[i] = mMid - TICK_SIZE * (i + 1);
+        mAskVolumes[i] = mBidVolumes[i] = 20 * (i + 1);
+    }
+}
+
+void WarmUpExchange::SendAmendOrder(unsigned long clientOrderId,
+                                    unsigned long volume) {
+    mMessages++;
+    PendingOrder *order = mOrders.Find(clientOrderId);
+    if (order == nullptr) {
+        return;
+    }
+    order->volume = volume > order->filledVolume ? volume : order->filledVolume;
+    QueueStatus(clientOrderId, *order);
+    if (order->volume == order->filledVolume) {
+        mOrders.Erase(order);
+    }
+}
+
+void WarmUpExchange::SendCancelOrder(unsigned long clientOrderId) {
+    mMessages++;
+    PendingOrder *order = mOrders.Find(clientOrderId);
+    if (order == nullptr) {
+        return;
+    }
+    order->volume = order->filledVolume;
+    QueueStatus(clientOrderId, *order);
+    mOrders.Erase(order);
+}
+
+void WarmUpExchange::SendHedgeOrder(unsigned long clientOrderId, Side,
+                                    unsigned long, unsigned long volume) {
+    mMessages++;
+    mCallbacks.push_back(
+        {CallbackType::HEDGE_FILLED, clientOrderId, mMid, volume, 0});
+}
+
+void WarmUpExchange::SendInsertOrder(unsigned long clientOrderId, Side,
+                                     unsigned long price, unsigned long volume,
+                                     Lifespan) {
+    mMessages++;
+    PendingOrder *order = mOrders.Insert(clientOrderId, {volume, 0});
+    if (order == nullptr || volume == 0) {
+        return;
+    }
+    if (++mInserts % FILL_EVERY == 0) {
+        order->filledVolume = 1;
+        mCallbacks.push_back(
+            {CallbackType::ORDER_FILLED, clientOrderId, price, 1, 0});
+    }
+    QueueStatus(clientOrderId, *order);
+    if (order->volume == order->filledVolume) {
+        mOrders.Erase(order);
+    }
+}
+
+void WarmUpExchange::QueueStatus(unsigned long clientOrderId,
+                                 const PendingOrder &order) {
+    mCallbacks.push_back({CallbackType::ORDER_STATUS, clientOrderId, 0,
+                          order.filledVolume,
+                          order.volume - order.filledVolume});
+}
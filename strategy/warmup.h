@@ -0,0 +1,162 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_WARMUP_H
+#define CPPREADY_TRADER_GO_WARMUP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+#include "executiongateway.h"
+#include "ordertable.h"
+
+// Plays the exchange for a throwaway copy of the strategy, run before the
+// market opens so that the first real event finds the code and the data
+// structures the two copies share (the allocator, the logging and the
+// strategy's own tables and branches) already warm.
+//
+// The books are synthetic: a price that wanders a few ticks up and down,
+// with a trade ticks message every other update. Nothing is sent anywhere.
+// Every insert, amend and cancel is acknowledged once the handler that
+// sent it returns, every third insert is filled for one lot so the fill
+// and hedge paths run too, and hedges fill in full at the future's mid
+// price. The clock moves on by one tick interval per update.
+class WarmUpExchange : public ExecutionGateway {
+public:
+    WarmUpExchange();
+
+    // Feeds the strategy the given number of future and ETF order book
+    // updates and answers every order it sends.
+    template <typename Logic> void Run(Logic &logic, unsigned long updates);
+
+    void SendAmendOrder(unsigned long clientOrderId,
+                        unsigned long volume) override;
+    void SendCancelOrder(unsigned long clientOrderId) override;
+    void SendHedgeOrder(unsigned long clientOrderId, ReadyTraderGo::Side side,
+                        unsigned long price, unsigned long volume) override;
+    void SendInsertOrder(unsigned long clientOrderId, ReadyTraderGo::Side side,
+                         unsigned long price, unsigned long volume,
+                         ReadyTraderGo::Lifespan lifespan) override;
+
+    std::uint64_t Now() const override { return mNow; }
+
+    // The number of messages the strategy sent.
+    unsigned long Messages() const { return mMessages; }
+
+private:
+    using Levels = std::array<unsigned long, ReadyTraderGo::TOP_LEVEL_COUNT>;
+
+    struct PendingOrder {
+        unsigned long volume;
+        unsigned long filledVolume;
+    };
+
+    enum class CallbackType : unsigned char {
+        HEDGE_FILLED,
+        ORDER_FILLED,
+        ORDER_STATUS
+    };
+
+    struct Callback {
+        CallbackType type;
+        unsigned long clientOrderId;
+        unsigned long price;
+        unsigned long volume;
+        unsigned long remainingVolume;
+    };
+
+    // Builds the books for the given update.
+    void MakeBook(unsigned long update);
+
+    void QueueStatus(unsigned long clientOrderId, const PendingOrder &order);
+
+    // Passes the queued callbacks, and any that they lead to, on to the
+    // strategy.
+    template <typename Logic> void Deliver(Logic &logic);
+
+    std::uint64_t mNow;
+    unsigned long mMessages = 0;
+    unsigned long mInserts = 0;
+
+    unsigned long mMid = 0;
+    Levels mAskPrices{};
+    Levels mAskVolumes{};
+    Levels mBidPrices{};
+    Levels mBidVolumes{};
+
+    OrderTable<PendingOrder, 64> mOrders;
+    std::vector<Callback> mCallbacks;
+};
+
+template <typename Logic>
+void WarmUpExchange::Run(Logic &logic, unsigned long updates) {
+    using ReadyTraderGo::Instrument;
+    const Levels none{};
+    for (unsigned long i = 0; i < updates; i++) {
+        MakeBook(i);
+        logic.OrderBookMessageHandler(Instrument::FUTURE, i + 1, mAskPrices,
+                                      mAskVolumes, mBidPrices, mBidVolumes);
+        Deliver(logic);
+        logic.OrderBookMessageHandler(Instrument::ETF, i + 1, mAskPrices,
+                                      mAskVolumes, mBidPrices, mBidVolumes);
+        Deliver(logic);
+        if (i % 2 == 1) {
+            // Trades at the touch, on one side or the other
+            Levels prices{};
+            Levels volumes{};
+            prices[0] = i % 4 == 1 ? mAskPrices[0] : mBidPrices[0];
+            volumes[0] = mAskVolumes[0];
+            if (i % 4 == 1) {
+                logic.TradeTicksMessageHandler(Instrument::ETF, i / 2 + 1,
+                                               prices, volumes, none, none);
+            } else {
+                logic.TradeTicksMessageHandler(Instrument::ETF, i / 2 + 1,
+                                               none, none, prices, volumes);
+            }
+            Deliver(logic);
+        }
+    }
+}
+
+template <typename Logic> void WarmUpExchange::Deliver(Logic &logic) {
+    // Handlers may send more orders, which queue more callbacks
+    for (std::size_t i = 0; i < mCallbacks.size(); i++) {
+        Callback callback = mCallbacks[i];
+        switch (callback.type) {
+        case CallbackType::HEDGE_FILLED:
+            logic.HedgeFilledMessageHandler(callback.clientOrderId,
+                                            callback.price, callback.volume);
+            break;
+        case CallbackType::ORDER_FILLED:
+            logic.OrderFilledMessageHandler(callback.clientOrderId,
+                                            callback.price, callback.volume);
+            break;
+        case CallbackType::ORDER_STATUS:
+            logic.OrderStatusMessageHandler(callback.clientOrderId,
+                                            callback.volume,
+                                            callback.remainingVolume, 0);
+            break;
+        }
+    }
+    mCallbacks.clear();
+}
+
+#endif // CPPREADY_TRADER_GO_WARMUP_H
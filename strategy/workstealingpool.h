@@ -0,0 +1,100 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_WORKSTEALINGPOOL_H
+#define CPPREADY_TRADER_GO_WORKSTEALINGPOOL_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a fixed batch of jobs across a number of threads.
+//
+// Jobs are dealt out round-robin before the threads start. Each worker runs
+// jobs from the front of its own queue and, once that is empty, steals from
+// the back of the others', so a few slow jobs never leave cores idle at the
+// end of a batch. No jobs are added while a batch runs, so a worker is done
+// as soon as it finds every queue empty.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(std::size_t threadCount)
+        : mThreadCount(threadCount == 0 ? 1 : threadCount) {}
+
+    std::size_t ThreadCount() const { return mThreadCount; }
+
+    // Calls job(index, worker) once for every index in [0, count), where
+    // worker identifies the calling thread, and returns once all have
+    // finished.
+    template <typename Job> void Run(std::size_t count, Job &&job) {
+        std::vector<std::unique_ptr<Queue>> queues;
+        for (std::size_t i = 0; i < mThreadCount; i++) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            queues[i % mThreadCount]->jobs.push_back(i);
+        }
+
+        std::vector<std::thread> threads;
+        for (std::size_t worker = 0; worker < mThreadCount; worker++) {
+            threads.emplace_back([&queues, &job, worker, this] {
+                std::size_t index;
+                while (Next(queues, worker, index)) {
+                    job(index, worker);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> jobs;
+    };
+
+    bool Next(std::vector<std::unique_ptr<Queue>> &queues, std::size_t worker,
+              std::size_t &index) const {
+        {
+            Queue &own = *queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                index = own.jobs.front();
+                own.jobs.pop_front();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < mThreadCount; i++) {
+            Queue &victim = *queues[(worker + i) % mThreadCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                index = victim.jobs.back();
+                victim.jobs.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t mThreadCount;
+};
+
+#endif // CPPREADY_TRADER_GO_WORKSTEALINGPOOL_H